@@ -0,0 +1,86 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// Storing, copying and casting values of mixed sizes with std::any and with
+// the basic_any of basic_any.hpp, with each of its storage policies.
+
+#include "basic_any.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <any>
+#include <array>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+
+// Payloads from 4 to 64 bytes, in random order
+template <typename Any>
+std::vector<Any> make_values(std::size_t n) {
+  std::mt19937 gen{42};
+  std::uniform_int_distribution<int> kinds{0, 4};
+  std::vector<Any> values;
+  values.reserve(n);
+  for (std::size_t i = 0; i != n; ++i) {
+    switch (kinds(gen)) {
+      case 0: values.emplace_back(static_cast<int>(i)); break;
+      case 1: values.emplace_back(static_cast<double>(i)); break;
+      case 2: values.emplace_back(std::array<double, 2>{{1.0, 2.0}}); break;
+      case 3: values.emplace_back(std::string{"property"}); break;
+      default: values.emplace_back(std::array<double, 8>{}); break;
+    }
+  }
+  return values;
+}
+
+template <typename Any>
+void store(benchmark::State& state) {
+  for (auto _ : state) {
+    auto values = make_values<Any>(state.range(0));
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Any>
+void copy(benchmark::State& state) {
+  auto const values = make_values<Any>(state.range(0));
+  for (auto _ : state) {
+    auto copies = values;
+    benchmark::DoNotOptimize(copies.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Looking for the ints in the bag, where most casts fail
+template <typename Any>
+void cast(benchmark::State& state) {
+  auto const values = make_values<Any>(state.range(0));
+  for (auto _ : state) {
+    long sum = 0;
+    for (auto const& value : values)
+      if (int const* i = any_cast<int>(&value))
+        sum += *i;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(store, std::any)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(store, any)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(store, inplace_any<64>)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(store, shared_any)->Arg(1 << 10)->Arg(1 << 16);
+
+BENCHMARK_TEMPLATE(copy, std::any)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(copy, any)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(copy, inplace_any<64>)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(copy, shared_any)->Arg(1 << 10)->Arg(1 << 16);
+
+BENCHMARK_TEMPLATE(cast, std::any)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(cast, any)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(cast, inplace_any<64>)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(cast, shared_any)->Arg(1 << 10)->Arg(1 << 16);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,249 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// std::sort, std::rotate and vector::erase on std::vector<Vehicle> spend
+// their time in move construction, move assignment and swap. This compares
+// an SBO Vehicle whose assignment destroys and reconstructs its object, and
+// which is swapped by std::swap's three moves, with one that assigns in
+// place when both types match and swaps without going through a temporary
+// Vehicle, like sbo_storage.hpp.
+
+#include "vtable.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace reconstruct {
+  class Vehicle {
+    vtable const* vptr_;
+    union { void* ptr_;
+            std::aligned_storage_t<16> buffer_; };
+    bool on_heap_;
+
+    void construct(Vehicle&& other) {
+      vptr_ = other.vptr_;
+      on_heap_ = other.on_heap_;
+      if (other.on_heap_)
+        ptr_ = std::exchange(other.ptr_, nullptr);
+      else
+        other.vptr_->move(&buffer_, &other.buffer_);
+    }
+
+    void destroy() {
+      if (on_heap_)
+        vptr_->delete_(ptr_);
+      else
+        vptr_->dtor(&buffer_);
+    }
+
+  public:
+    template <typename Any>
+    Vehicle(Any vehicle) : vptr_{&vtable_for<Any>} {
+      if constexpr (sizeof(Any) > 16) {
+        on_heap_ = true;
+        ptr_ = new Any(std::move(vehicle));
+      } else {
+        on_heap_ = false;
+        new (&buffer_) Any{std::move(vehicle)};
+      }
+    }
+
+    Vehicle(Vehicle&& other) noexcept
+    { construct(std::move(other)); }
+
+    Vehicle& operator=(Vehicle&& other) noexcept {
+      if (this != &other) {
+        destroy();
+        construct(std::move(other));
+      }
+      return *this;
+    }
+
+    void const* get() const
+    { return on_heap_ ? ptr_ : &buffer_; }
+
+    ~Vehicle()
+    { destroy(); }
+  };
+}
+
+namespace in_place {
+  class Vehicle {
+    vtable const* vptr_;
+    union { void* ptr_;
+            std::aligned_storage_t<16> buffer_; };
+    bool on_heap_;
+
+    void construct(Vehicle&& other) {
+      vptr_ = other.vptr_;
+      on_heap_ = other.on_heap_;
+      if (other.on_heap_)
+        ptr_ = std::exchange(other.ptr_, nullptr);
+      else
+        other.vptr_->move(&buffer_, &other.buffer_);
+    }
+
+    void destroy() {
+      if (on_heap_)
+        vptr_->delete_(ptr_);
+      else
+        vptr_->dtor(&buffer_);
+    }
+
+  public:
+    template <typename Any>
+    Vehicle(Any vehicle) : vptr_{&vtable_for<Any>} {
+      if constexpr (sizeof(Any) > 16) {
+        on_heap_ = true;
+        ptr_ = new Any(std::move(vehicle));
+      } else {
+        on_heap_ = false;
+        new (&buffer_) Any{std::move(vehicle)};
+      }
+    }
+
+    Vehicle(Vehicle&& other) noexcept
+    { construct(std::move(other)); }
+
+    Vehicle& operator=(Vehicle&& other) noexcept {
+      if (this == &other)
+        return *this;
+      if (on_heap_ && other.on_heap_) {
+        std::swap(vptr_, other.vptr_);
+        std::swap(ptr_, other.ptr_);
+      } else if (vptr_ == other.vptr_) {
+        vptr_->move_assign(&buffer_, &other.buffer_);
+      } else {
+        destroy();
+        construct(std::move(other));
+      }
+      return *this;
+    }
+
+    friend void swap(Vehicle& a, Vehicle& b) noexcept {
+      if (&a == &b) {
+        return;
+      } else if (a.on_heap_ && b.on_heap_) {
+        std::swap(a.vptr_, b.vptr_);
+        std::swap(a.ptr_, b.ptr_);
+      } else if (a.vptr_ == b.vptr_) {
+        a.vptr_->swap(&a.buffer_, &b.buffer_);
+      } else if (a.on_heap_ != b.on_heap_) {
+        Vehicle& local = a.on_heap_ ? b : a;
+        Vehicle& remote = a.on_heap_ ? a : b;
+        void* ptr = remote.ptr_;
+        local.vptr_->move(&remote.buffer_, &local.buffer_);
+        local.vptr_->dtor(&local.buffer_);
+        local.ptr_ = ptr;
+        std::swap(a.vptr_, b.vptr_);
+        std::swap(a.on_heap_, b.on_heap_);
+      } else {
+        std::aligned_storage_t<16> tmp;
+        a.vptr_->move(&tmp, &a.buffer_);
+        a.vptr_->dtor(&a.buffer_);
+        b.vptr_->move(&a.buffer_, &b.buffer_);
+        b.vptr_->dtor(&b.buffer_);
+        a.vptr_->move(&b.buffer_, &tmp);
+        a.vptr_->dtor(&tmp);
+        std::swap(a.vptr_, b.vptr_);
+      }
+    }
+
+    void const* get() const
+    { return on_heap_ ? ptr_ : &buffer_; }
+
+    ~Vehicle()
+    { destroy(); }
+  };
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+// Every payload starts with its year, so the comparison can read it without
+// knowing the type. Bike and Scooter are stored inline, Car and Truck are not.
+struct Bike    { int year; int speed; void accelerate() { } };
+struct Scooter { int year; int speed; void accelerate() { } };
+struct Car     { int year; std::string make; void accelerate() { } };
+struct Truck   { int year; std::string make; void accelerate() { } };
+
+template <typename Vehicle>
+int year(Vehicle const& vehicle) {
+  return *static_cast<int const*>(vehicle.get());
+}
+
+template <typename Vehicle>
+std::vector<Vehicle> make_fleet(std::size_t n) {
+  std::mt19937 gen{42};
+  std::uniform_int_distribution<int> kinds{0, 3}, years{1990, 2018};
+  std::vector<Vehicle> fleet;
+  fleet.reserve(n);
+  for (std::size_t i = 0; i != n; ++i) {
+    int y = years(gen);
+    switch (kinds(gen)) {
+      case 0: fleet.emplace_back(Bike{y, 0}); break;
+      case 1: fleet.emplace_back(Scooter{y, 0}); break;
+      case 2: fleet.emplace_back(Car{y, "Audi"}); break;
+      default: fleet.emplace_back(Truck{y, "Chevrolet"}); break;
+    }
+  }
+  return fleet;
+}
+
+template <typename Vehicle>
+void sort(benchmark::State& state) {
+  std::size_t const n = state.range(0);
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto fleet = make_fleet<Vehicle>(n);
+    state.ResumeTiming();
+    std::sort(fleet.begin(), fleet.end(), [](Vehicle const& a, Vehicle const& b) {
+      return year(a) < year(b);
+    });
+    benchmark::DoNotOptimize(fleet.data());
+    state.PauseTiming();
+    fleet.clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <typename Vehicle>
+void rotate(benchmark::State& state) {
+  std::size_t const n = state.range(0);
+  auto fleet = make_fleet<Vehicle>(n);
+  for (auto _ : state) {
+    std::rotate(fleet.begin(), fleet.begin() + n / 3, fleet.end());
+    benchmark::DoNotOptimize(fleet.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Erases the first element, and puts a new one at the back
+template <typename Vehicle>
+void erase(benchmark::State& state) {
+  std::size_t const n = state.range(0);
+  auto fleet = make_fleet<Vehicle>(n);
+  for (auto _ : state) {
+    fleet.erase(fleet.begin());
+    fleet.emplace_back(Bike{2018, 0});
+    benchmark::DoNotOptimize(fleet.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_TEMPLATE(sort, reconstruct::Vehicle)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(sort, in_place::Vehicle)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(rotate, reconstruct::Vehicle)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(rotate, in_place::Vehicle)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(erase, reconstruct::Vehicle)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(erase, in_place::Vehicle)->Range(1 << 10, 1 << 18);
+
+BENCHMARK_MAIN();
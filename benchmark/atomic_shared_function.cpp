@@ -0,0 +1,67 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#include "atomic_shared_function.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+
+
+// Thread 0 is the writer and reconfigures the handler every `period` calls;
+// every other thread only calls it.
+constexpr int period = 10000;
+
+static void mutex(benchmark::State& state) {
+  static std::mutex m;
+  static std::function<int(int)> handler = [](int i) { return i; };
+
+  int n = 0;
+  for (auto _ : state) {
+    if (state.thread_index() == 0 && ++n % period == 0) {
+      std::lock_guard<std::mutex> lock{m};
+      handler = [n](int i) { return i + n; };
+    }
+    std::lock_guard<std::mutex> lock{m};
+    benchmark::DoNotOptimize(handler(1));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Lock-free through std::atomic_load on a shared_ptr, which still bumps a
+// shared reference count on every call.
+static void shared_ptr(benchmark::State& state) {
+  static std::shared_ptr<std::function<int(int)>> handler =
+    std::make_shared<std::function<int(int)>>([](int i) { return i; });
+
+  int n = 0;
+  for (auto _ : state) {
+    if (state.thread_index() == 0 && ++n % period == 0) {
+      std::atomic_store(&handler, std::make_shared<std::function<int(int)>>(
+        [n](int i) { return i + n; }));
+    }
+    auto snapshot = std::atomic_load(&handler);
+    benchmark::DoNotOptimize((*snapshot)(1));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void epoch(benchmark::State& state) {
+  static atomic_shared_function<int(int)> handler{[](int i) { return i; }};
+
+  int n = 0;
+  for (auto _ : state) {
+    if (state.thread_index() == 0 && ++n % period == 0)
+      handler.store([n](int i) { return i + n; });
+    benchmark::DoNotOptimize(handler(1));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(mutex)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(shared_ptr)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(epoch)->ThreadRange(1, 16)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+# Copyright Louis Dionne 2018
+# Distributed under the Boost Software License, Version 1.0.
+
+"""Runs benchmarks and compares them against a committed baseline.
+
+Each benchmark executable is run with repetitions, and every benchmark is
+summarized by the median and the median absolute deviation (MAD) of its CPU
+time across repetitions. A benchmark regresses when its median exceeds the
+baseline median by more than
+
+    --sigmas times the combined MAD of the baseline and the current run,
+
+so stable benchmarks get a tighter threshold than noisy ones, but never by
+more than --tolerance (relative) of the baseline median, so noise can't hide
+a regression larger than the tolerance. A baseline entry can override the
+tolerance with its own "tolerance" field.
+
+A benchmark missing from the baseline is an error too, since it can't be
+checked; record it with --update first.
+
+Usage:
+    bench_check.py --baseline baseline.json [--update]
+                   [--build-type Release] benchmark...
+
+With --update, the baseline is rewritten from the current run instead. The
+baseline is recorded from a Release build, so nothing is run when
+--build-type is given and is anything else.
+"""
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+
+
+def median_and_mad(values):
+    median = statistics.median(values)
+    mad = statistics.median(abs(v - median) for v in values)
+    return median, mad
+
+
+def run(executable, repetitions, min_time, extra):
+    """Returns {name: (median, mad)} for every benchmark in `executable`."""
+    with tempfile.TemporaryDirectory() as tmp:
+        out = os.path.join(tmp, 'out.json')
+        subprocess.run([executable,
+                        '--benchmark_repetitions={}'.format(repetitions),
+                        '--benchmark_min_time={}'.format(min_time),
+                        # Spread the repetitions of each benchmark over the
+                        # whole run, so that their spread also accounts for
+                        # the machine getting slower or faster over time.
+                        '--benchmark_enable_random_interleaving=true',
+                        '--benchmark_out={}'.format(out),
+                        '--benchmark_out_format=json'] + extra,
+                       check=True, stdout=sys.stderr)
+        with open(out) as f:
+            report = json.load(f)
+
+    times = {}
+    for b in report['benchmarks']:
+        if b.get('run_type', 'iteration') != 'iteration':
+            continue  # aggregates are recomputed below
+        name = b.get('run_name', b['name'])
+        times.setdefault(name, []).append(b['cpu_time'])
+
+    prefix = os.path.basename(executable)
+    return {'{}:{}'.format(prefix, name): median_and_mad(values)
+            for name, values in times.items()}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--baseline', required=True)
+    parser.add_argument('--update', action='store_true')
+    parser.add_argument('--build-type',
+                        help='build type of the benchmarks, which must be Release')
+    parser.add_argument('--repetitions', type=int, default=30)
+    parser.add_argument('--min-time', type=float, default=0.1)
+    parser.add_argument('--sigmas', type=float, default=3.0)
+    parser.add_argument('--tolerance', type=float, default=0.05)
+    parser.add_argument('--benchmark-arg', action='append', default=[],
+                        help='extra argument passed to every benchmark')
+    parser.add_argument('benchmarks', nargs='+')
+    args = parser.parse_args()
+
+    if args.build_type is not None and args.build_type != 'Release':
+        print("The baseline is only meaningful for a Release build, but the "
+              "benchmarks were built with build type '{}'".format(args.build_type),
+              file=sys.stderr)
+        return 1
+
+    current = {}
+    for executable in args.benchmarks:
+        current.update(run(executable, args.repetitions, args.min_time, args.benchmark_arg))
+
+    if args.update:
+        baseline = {}
+        if os.path.exists(args.baseline):
+            with open(args.baseline) as f:
+                baseline = json.load(f)
+        for name, (median, mad) in current.items():
+            entry = {'median': median, 'mad': mad}
+            if 'tolerance' in baseline.get(name, {}):
+                entry['tolerance'] = baseline[name]['tolerance']
+            baseline[name] = entry
+        with open(args.baseline, 'w') as f:
+            json.dump(baseline, f, indent=2, sort_keys=True)
+            f.write('\n')
+        print('Updated {} with {} benchmarks'.format(args.baseline, len(current)))
+        return 0
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+
+    regressions = 0
+    unknown = 0
+    for name in sorted(current):
+        median, mad = current[name]
+        if name not in baseline:
+            print('{:<70} {:>12.1f}  NOT IN THE BASELINE'.format(name, median))
+            unknown += 1
+            continue
+        base = baseline[name]
+        tolerance = base.get('tolerance', args.tolerance)
+        threshold = min(args.sigmas * (base['mad'] + mad), tolerance * base['median'])
+        change = (median - base['median']) / base['median'] if base['median'] else 0.0
+        status = 'ok'
+        if median > base['median'] + threshold:
+            status = 'REGRESSION'
+            regressions += 1
+        elif median < base['median'] - threshold:
+            status = 'improved'
+        print('{:<70} {:>12.1f} {:>12.1f} {:>+8.1%}  {}'.format(
+              name, base['median'], median, change, status))
+
+    for name in sorted(set(baseline) - set(current)):
+        print('{:<70} missing from this run'.format(name))
+
+    if unknown:
+        print('{} benchmark(s) are not in the baseline; record them with '
+              'bench-update-baseline'.format(unknown))
+    if regressions:
+        print('{} benchmark(s) regressed'.format(regressions))
+    return 1 if regressions or unknown else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
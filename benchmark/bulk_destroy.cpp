@@ -0,0 +1,70 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// Tearing down a fleet with vector::clear(), which goes through the vtable
+// once per element, and with clear() from bulk_destroy.hpp, which skips
+// trivially destructible inline objects and destroys the others in batches.
+
+#include "bulk_destroy.hpp"
+#include "sbo_storage.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+
+//////////////////////////////////////////////////////////////////////////////
+// Bike and Scooter are stored inline and trivially destructible, Car and
+// Truck are on the heap.
+struct Bike    { int year; void accelerate() { } };
+struct Scooter { int year; int speed; void accelerate() { } };
+struct Car     { std::string make; int year; void accelerate() { } };
+struct Truck   { std::string make; int year; void accelerate() { } };
+
+template <typename Vehicle>
+std::vector<Vehicle> make_fleet(std::size_t n, int heap_percent) {
+  std::mt19937 gen{42};
+  std::uniform_int_distribution<int> percent{0, 99}, coin{0, 1};
+  std::vector<Vehicle> fleet;
+  fleet.reserve(n);
+  for (std::size_t i = 0; i != n; ++i) {
+    bool heap = percent(gen) < heap_percent;
+    if (heap)
+      coin(gen) ? fleet.emplace_back(Car{"Audi", 2017}) : fleet.emplace_back(Truck{"Chevrolet", 2015});
+    else
+      coin(gen) ? fleet.emplace_back(Bike{2018}) : fleet.emplace_back(Scooter{2016, 0});
+  }
+  return fleet;
+}
+
+// The first argument is the size of the fleet, the second the percentage of
+// its vehicles that live on the heap.
+static void vector_clear(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto fleet = make_fleet<sbo_storage::Vehicle<16>>(state.range(0), state.range(1));
+    state.ResumeTiming();
+    fleet.clear();
+    benchmark::DoNotOptimize(fleet.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void bulk_clear(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto fleet = make_fleet<sbo_storage::Vehicle<16>>(state.range(0), state.range(1));
+    state.ResumeTiming();
+    clear(fleet);
+    benchmark::DoNotOptimize(fleet.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(vector_clear)->ArgsProduct({{1 << 10, 1 << 14, 1 << 18}, {0, 10, 50, 100}});
+BENCHMARK(bulk_clear)->ArgsProduct({{1 << 10, 1 << 14, 1 << 18}, {0, 10, 50, 100}});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,200 @@
+#!/usr/bin/env python3
+# Copyright Louis Dionne 2018
+# Distributed under the Boost Software License, Version 1.0.
+
+"""Measures the build cost of type erasure with Dyno and with hand-written vtables.
+
+For each style, a translation unit is generated with N concepts and M types
+modeling all of them, where every type is erased through every concept (N * M
+vtables). Both styles use remote storage, and their concepts have the same
+members: a mutating method, a const method returning a value, copy and
+destruction. Each translation unit is compiled once, and the following is
+recorded:
+
+    compile time       wall-clock time of the compiler, in seconds
+    peak memory        maximum resident set size of the compiler, in MB
+    object size        size of the object file, in bytes
+    text size          size of the code and read-only data, in bytes
+    symbols            number of symbols defined by the object file
+
+Usage:
+    compile_cost.py [--compiler c++] [--concepts N] [--types M]
+                    [--include-dirs dir;dir...] [--flag=-O2]... [--json out.json]
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+
+def generate_handwritten(concepts, types):
+    out = ['#include <new>', '#include <utility>', '']
+    for c in range(concepts):
+        out += [
+            'struct vtable{c} {{'.format(c=c),
+            '  void (*accelerate)(void* this_);',
+            '  int (*speed)(void const* this_);',
+            '  void* (*clone)(void const* this_);',
+            '  void (*delete_)(void* this_);',
+            '};',
+            '',
+            'template <typename T>',
+            'constexpr vtable{c} vtable{c}_for = {{'.format(c=c),
+            '  [](void* this_) {{ static_cast<T*>(this_)->accelerate{c}(); }},'.format(c=c),
+            '  [](void const* this_) {{ return static_cast<T const*>(this_)->speed{c}(); }},'.format(c=c),
+            '  [](void const* this_) -> void* { return new T(*static_cast<T const*>(this_)); },',
+            '  [](void* this_) { delete static_cast<T*>(this_); }',
+            '};',
+            '',
+            'class Concept{c} {{'.format(c=c),
+            '  vtable{c} const* vptr_;'.format(c=c),
+            '  void* ptr_;',
+            'public:',
+            '  template <typename Any>',
+            '  Concept{c}(Any x) : vptr_{{&vtable{c}_for<Any>}}, ptr_{{new Any(std::move(x))}} {{ }}'.format(c=c),
+            '  Concept{c}(Concept{c} const& other)'.format(c=c),
+            '    : vptr_{other.vptr_}, ptr_{other.vptr_->clone(other.ptr_)} { }',
+            '  void accelerate() { vptr_->accelerate(ptr_); }',
+            '  int speed() const { return vptr_->speed(ptr_); }',
+            '  ~Concept{c}() {{ vptr_->delete_(ptr_); }}'.format(c=c),
+            '};',
+            '',
+        ]
+    out += generate_types(concepts, types)
+    return '\n'.join(out) + '\n'
+
+
+def generate_dyno(concepts, types):
+    out = ['#include <dyno.hpp>', '#include <new>', '#include <utility>',
+           'using namespace dyno::literals;', '']
+    for c in range(concepts):
+        out += [
+            'struct IConcept{c} : decltype(dyno::requires('.format(c=c),
+            '  dyno::CopyConstructible{},',
+            '  dyno::Destructible{},',
+            '  "accelerate"_s = dyno::function<void (dyno::T&)>,',
+            '  "speed"_s = dyno::function<int (dyno::T const&)>',
+            ')) { };',
+            '',
+            'template <typename T>',
+            'auto const dyno::default_concept_map<IConcept{c}, T> = dyno::make_concept_map('.format(c=c),
+            '  "accelerate"_s = [](T& self) {{ self.accelerate{c}(); }},'.format(c=c),
+            '  "speed"_s = [](T const& self) {{ return self.speed{c}(); }}'.format(c=c),
+            ');',
+            '',
+            'class Concept{c} {{'.format(c=c),
+            '  dyno::poly<IConcept{c}, dyno::remote_storage> poly_;'.format(c=c),
+            'public:',
+            '  template <typename Any>',
+            '  Concept{c}(Any x) : poly_{{std::move(x)}} {{ }}'.format(c=c),
+            '  void accelerate() { poly_.virtual_("accelerate"_s)(poly_); }',
+            '  int speed() const { return poly_.virtual_("speed"_s)(poly_); }',
+            '};',
+            '',
+        ]
+    out += generate_types(concepts, types)
+    return '\n'.join(out) + '\n'
+
+
+# Every type models every concept, and has a function erasing it through
+# each of them, so that all the vtables are instantiated and emitted.
+def generate_types(concepts, types):
+    out = []
+    for t in range(types):
+        out.append('struct Type{t} {{'.format(t=t))
+        out.append('  int value;')
+        for c in range(concepts):
+            out.append('  void accelerate{c}() {{ value += {k}; }}'.format(c=c, k=c + t))
+            out.append('  int speed{c}() const {{ return value * {k}; }}'.format(c=c, k=c + 1))
+        out.append('};')
+        params = ', '.join('Concept{c}* out{c}'.format(c=c) for c in range(concepts))
+        out.append('void make{t}({params}) {{'.format(t=t, params=params))
+        for c in range(concepts):
+            out.append('  new (out{c}) Concept{c}{{Type{t}{{{t}}}}};'.format(c=c, t=t))
+        out.append('}')
+        out.append('')
+    return out
+
+
+def compile_and_measure(compiler, flags, source, obj):
+    command = [compiler] + flags + ['-c', source, '-o', obj]
+    start = time.monotonic()
+    process = subprocess.Popen(command)
+    # The rusage of the compiler driver includes the compiler proper it
+    # waited for, and ru_maxrss is then the peak of the largest of them.
+    _, status, usage = os.wait4(process.pid, 0)
+    elapsed = time.monotonic() - start
+    if os.waitstatus_to_exitcode(status) != 0:
+        raise RuntimeError('failed to compile {}'.format(source))
+
+    text = 0
+    sizes = subprocess.run(['size', '-A', obj], check=True, capture_output=True, text=True)
+    for line in sizes.stdout.splitlines():
+        fields = line.split()
+        if len(fields) >= 2 and fields[0].startswith(('.text', '.rodata', '.data.rel.ro')):
+            text += int(fields[1])
+    symbols = subprocess.run(['nm', '--defined-only', obj], check=True,
+                             capture_output=True, text=True).stdout.count('\n')
+
+    return {
+        'compile_time': elapsed,
+        'peak_memory_mb': usage.ru_maxrss / 1024.0,
+        'object_size': os.path.getsize(obj),
+        'text_size': text,
+        'symbols': symbols,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--compiler', default=os.environ.get('CXX', 'c++'))
+    parser.add_argument('--concepts', type=int, default=10)
+    parser.add_argument('--types', type=int, default=1000)
+    parser.add_argument('--include-dirs', default='',
+                        help='semicolon-separated include directories for Dyno')
+    parser.add_argument('--flag', action='append', default=None,
+                        help='compiler flag, -std=c++17 and -O2 by default')
+    parser.add_argument('--style', action='append', choices=['handwritten', 'dyno'],
+                        help='styles to measure, all of them by default')
+    parser.add_argument('--json', help='also write the results to this file')
+    args = parser.parse_args()
+
+    flags = args.flag if args.flag is not None else ['-std=c++17', '-O2']
+    flags = flags + ['-I' + d for d in args.include_dirs.split(';') if d]
+    generators = {'handwritten': generate_handwritten, 'dyno': generate_dyno}
+    styles = args.style or list(generators)
+
+    results = {}
+    with tempfile.TemporaryDirectory() as tmp:
+        for style in styles:
+            source = os.path.join(tmp, style + '.cpp')
+            with open(source, 'w') as f:
+                f.write(generators[style](args.concepts, args.types))
+            print('Compiling {} concepts x {} types ({})...'.format(
+                  args.concepts, args.types, style), file=sys.stderr)
+            results[style] = compile_and_measure(args.compiler, flags, source,
+                                                 os.path.join(tmp, style + '.o'))
+
+    print('{:<12} {:>12} {:>12} {:>14} {:>14} {:>10}'.format(
+          'style', 'time (s)', 'memory (MB)', 'object (B)', 'text (B)', 'symbols'))
+    for style, r in results.items():
+        print('{:<12} {:>12.2f} {:>12.1f} {:>14} {:>14} {:>10}'.format(
+              style, r['compile_time'], r['peak_memory_mb'], r['object_size'],
+              r['text_size'], r['symbols']))
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump({'concepts': args.concepts, 'types': args.types,
+                       'compiler': args.compiler, 'flags': flags,
+                       'results': results}, f, indent=2, sort_keys=True)
+            f.write('\n')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,125 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#include "vtable.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+// Constructor as it was: takes the object by value and copies it again.
+class CopyingVehicle {
+  vtable const* const vptr_;
+  void* ptr_;
+
+public:
+  template <typename Any>
+  CopyingVehicle(Any vehicle)
+    : vptr_{&vtable_for<Any>}
+    , ptr_{new Any(vehicle)}
+  { }
+
+  CopyingVehicle(CopyingVehicle const& other)
+    : vptr_{other.vptr_}
+    , ptr_{other.vptr_->clone(other.ptr_)}
+  { }
+
+  ~CopyingVehicle()
+  { vptr_->delete_(ptr_); }
+};
+
+class Vehicle {
+  vtable const* const vptr_;
+  void* ptr_;
+
+public:
+  template <typename Any>
+  Vehicle(Any vehicle)
+    : vptr_{&vtable_for<Any>}
+    , ptr_{new Any(std::move(vehicle))}
+  { }
+
+  template <typename Any, typename ...Args>
+  Vehicle(std::in_place_type_t<Any>, Args&& ...args)
+    : vptr_{&vtable_for<Any>}
+    , ptr_{new Any(std::forward<Args>(args)...)}
+  { }
+
+  Vehicle(Vehicle const& other)
+    : vptr_{other.vptr_}
+    , ptr_{other.vptr_->clone(other.ptr_)}
+  { }
+
+  ~Vehicle()
+  { vptr_->delete_(ptr_); }
+};
+
+// Strings are too long for the small string optimization, so every copy of
+// a Plane allocates.
+struct Plane {
+  Plane(std::string make, std::string model)
+    : make(std::move(make)), model(std::move(model))
+  { }
+  std::string make;
+  std::string model;
+  void accelerate() { }
+};
+
+static std::string const make = "Boeing Commercial Airplanes, Renton";
+static std::string const model = "747-8 Intercontinental, long range";
+
+static void copy(benchmark::State& state) {
+  for (auto _ : state) {
+    CopyingVehicle vehicle{Plane{make, model}};
+    benchmark::DoNotOptimize(&vehicle);
+  }
+}
+
+static void move(benchmark::State& state) {
+  for (auto _ : state) {
+    Vehicle vehicle{Plane{make, model}};
+    benchmark::DoNotOptimize(&vehicle);
+  }
+}
+
+static void in_place(benchmark::State& state) {
+  for (auto _ : state) {
+    Vehicle vehicle{std::in_place_type<Plane>, make, model};
+    benchmark::DoNotOptimize(&vehicle);
+  }
+}
+
+// Loading a whole fleet, where the vector is reserved up front.
+static void fleet_copy(benchmark::State& state) {
+  for (auto _ : state) {
+    std::vector<CopyingVehicle> fleet;
+    fleet.reserve(state.range(0));
+    for (std::size_t i = 0; i != fleet.capacity(); ++i)
+      fleet.emplace_back(Plane{make, model});
+    benchmark::DoNotOptimize(fleet.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void fleet_in_place(benchmark::State& state) {
+  for (auto _ : state) {
+    std::vector<Vehicle> fleet;
+    fleet.reserve(state.range(0));
+    for (std::size_t i = 0; i != fleet.capacity(); ++i)
+      fleet.emplace_back(std::in_place_type<Plane>, make, model);
+    benchmark::DoNotOptimize(fleet.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(copy);
+BENCHMARK(move);
+BENCHMARK(in_place);
+BENCHMARK(fleet_copy)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(fleet_in_place)->Arg(1 << 10)->Arg(1 << 16);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,103 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// Dispatch cost of every storage and vtable technique from the talk, with the
+// hand-written handles of code/*.hpp, which are the ones on the slides.
+// Besides time, each benchmark reports hardware counters per dispatch (see
+// perf_counters.hpp).
+
+#include "joined_vtable.hpp"
+#include "local_storage.hpp"
+#include "local_vtable.hpp"
+#include "perf_counters.hpp"
+#include "remote_storage.hpp"
+#include "sbo_storage.hpp"
+#include "shared_remote_storage.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+
+namespace inheritance {
+  struct Vehicle {
+    virtual void accelerate() = 0;
+    virtual ~Vehicle() { }
+  };
+
+  template <typename Any>
+  struct Model : Vehicle {
+    explicit Model(Any v) : v_(std::move(v)) { }
+    void accelerate() override { v_.accelerate(); }
+    Any v_;
+  };
+
+  struct Handle {
+    template <typename Any>
+    Handle(Any vehicle) : ptr_{std::make_unique<Model<Any>>(std::move(vehicle))} { }
+    void accelerate() { ptr_->accelerate(); }
+    std::unique_ptr<Vehicle> ptr_;
+  };
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+// Payloads of `Size` bytes
+template <std::size_t Size>
+struct Car   { int speed; char pad[Size - sizeof(int)]; void accelerate() { speed += 1; } };
+template <std::size_t Size>
+struct Truck { int speed; char pad[Size - sizeof(int)]; void accelerate() { speed += 2; } };
+template <std::size_t Size>
+struct Plane { int speed; char pad[Size - sizeof(int)]; void accelerate() { speed += 3; } };
+
+// The types of the vehicles are in random order, so the indirect branch is
+// hard to predict.
+template <typename Vehicle, std::size_t Size>
+std::vector<Vehicle> make_fleet(std::size_t n) {
+  std::vector<int> kinds(n);
+  for (std::size_t i = 0; i != n; ++i)
+    kinds[i] = i % 3;
+  std::shuffle(kinds.begin(), kinds.end(), std::mt19937{42});
+
+  std::vector<Vehicle> fleet;
+  fleet.reserve(n);
+  for (int kind : kinds) {
+    if (kind == 0)      fleet.emplace_back(Car<Size>{});
+    else if (kind == 1) fleet.emplace_back(Truck<Size>{});
+    else                fleet.emplace_back(Plane<Size>{});
+  }
+  return fleet;
+}
+
+template <typename Vehicle, std::size_t Size>
+void dispatch(benchmark::State& state) {
+  auto fleet = make_fleet<Vehicle, Size>(state.range(0));
+
+  perf_counters counters;
+  for (auto _ : state) {
+    for (auto& vehicle : fleet)
+      vehicle.accelerate();
+    benchmark::ClobberMemory();
+  }
+  counters.report(state, static_cast<double>(state.iterations()) * fleet.size());
+  state.SetItemsProcessed(state.iterations() * fleet.size());
+}
+
+#define DISPATCH_BENCHMARKS(SIZE)                                                         \
+  BENCHMARK_TEMPLATE(dispatch, inheritance::Handle, SIZE)->Arg(1 << 10)->Arg(1 << 20);    \
+  BENCHMARK_TEMPLATE(dispatch, remote_storage::Vehicle, SIZE)->Arg(1 << 10)->Arg(1 << 20); \
+  BENCHMARK_TEMPLATE(dispatch, sbo_storage::Vehicle<16>, SIZE)->Arg(1 << 10)->Arg(1 << 20); \
+  BENCHMARK_TEMPLATE(dispatch, local_storage::Vehicle, SIZE)->Arg(1 << 10)->Arg(1 << 20); \
+  BENCHMARK_TEMPLATE(dispatch, shared_remote_storage::Vehicle, SIZE)->Arg(1 << 10)->Arg(1 << 20); \
+  BENCHMARK_TEMPLATE(dispatch, local_vtable::Vehicle, SIZE)->Arg(1 << 10)->Arg(1 << 20);  \
+  BENCHMARK_TEMPLATE(dispatch, joined_vtable::Vehicle, SIZE)->Arg(1 << 10)->Arg(1 << 20)
+
+DISPATCH_BENCHMARKS(8);
+DISPATCH_BENCHMARKS(32);
+
+BENCHMARK_MAIN();
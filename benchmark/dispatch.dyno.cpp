@@ -0,0 +1,98 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// Same as dispatch.cpp, but with the Dyno implementations of every storage
+// and vtable policy.
+
+#include "perf_counters.hpp"
+#include "vtable.dyno.hpp"
+
+#include <benchmark/benchmark.h>
+#include <dyno.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <utility>
+#include <vector>
+using namespace dyno::literals;
+
+
+template <typename StoragePolicy,
+          typename VTablePolicy = dyno::vtable<dyno::remote<dyno::everything>>>
+struct Vehicle {
+  template <typename Any>
+  Vehicle(Any vehicle) : poly_{std::move(vehicle)} { }
+
+  void accelerate()
+  { poly_.virtual_("accelerate"_s)(poly_); }
+
+private:
+  dyno::poly<IVehicle, StoragePolicy, VTablePolicy> poly_;
+};
+
+using remote_storage = Vehicle<dyno::remote_storage>;
+template <std::size_t Size>
+using sbo_storage = Vehicle<dyno::sbo_storage<Size>>;
+template <std::size_t Size>
+using local_storage = Vehicle<dyno::local_storage<Size>>;
+using shared_remote_storage = Vehicle<dyno::shared_remote_storage>;
+using local_vtable = Vehicle<dyno::remote_storage,
+                             dyno::vtable<dyno::local<dyno::everything>>>;
+using joined_vtable = Vehicle<dyno::remote_storage,
+                              dyno::vtable<
+                                dyno::local<dyno::only<decltype("accelerate"_s)>>,
+                                dyno::remote<dyno::everything_else>>>;
+
+
+//////////////////////////////////////////////////////////////////////////////
+template <std::size_t Size>
+struct Car   { int speed; char pad[Size - sizeof(int)]; void accelerate() { speed += 1; } };
+template <std::size_t Size>
+struct Truck { int speed; char pad[Size - sizeof(int)]; void accelerate() { speed += 2; } };
+template <std::size_t Size>
+struct Plane { int speed; char pad[Size - sizeof(int)]; void accelerate() { speed += 3; } };
+
+template <typename V, std::size_t Size>
+std::vector<V> make_fleet(std::size_t n) {
+  std::vector<int> kinds(n);
+  for (std::size_t i = 0; i != n; ++i)
+    kinds[i] = i % 3;
+  std::shuffle(kinds.begin(), kinds.end(), std::mt19937{42});
+
+  std::vector<V> fleet;
+  fleet.reserve(n);
+  for (int kind : kinds) {
+    if (kind == 0)      fleet.emplace_back(Car<Size>{});
+    else if (kind == 1) fleet.emplace_back(Truck<Size>{});
+    else                fleet.emplace_back(Plane<Size>{});
+  }
+  return fleet;
+}
+
+template <typename V, std::size_t Size>
+void dispatch(benchmark::State& state) {
+  auto fleet = make_fleet<V, Size>(state.range(0));
+
+  perf_counters counters;
+  for (auto _ : state) {
+    for (auto& vehicle : fleet)
+      vehicle.accelerate();
+    benchmark::ClobberMemory();
+  }
+  counters.report(state, static_cast<double>(state.iterations()) * fleet.size());
+  state.SetItemsProcessed(state.iterations() * fleet.size());
+}
+
+#define DISPATCH_BENCHMARKS(SIZE)                                                         \
+  BENCHMARK_TEMPLATE(dispatch, remote_storage, SIZE)->Arg(1 << 10)->Arg(1 << 20);          \
+  BENCHMARK_TEMPLATE(dispatch, sbo_storage<16>, SIZE)->Arg(1 << 10)->Arg(1 << 20);         \
+  BENCHMARK_TEMPLATE(dispatch, local_storage<SIZE>, SIZE)->Arg(1 << 10)->Arg(1 << 20);     \
+  BENCHMARK_TEMPLATE(dispatch, shared_remote_storage, SIZE)->Arg(1 << 10)->Arg(1 << 20);   \
+  BENCHMARK_TEMPLATE(dispatch, local_vtable, SIZE)->Arg(1 << 10)->Arg(1 << 20);            \
+  BENCHMARK_TEMPLATE(dispatch, joined_vtable, SIZE)->Arg(1 << 10)->Arg(1 << 20)
+
+DISPATCH_BENCHMARKS(8);
+DISPATCH_BENCHMARKS(32);
+
+BENCHMARK_MAIN();
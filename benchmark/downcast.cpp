@@ -0,0 +1,130 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#include "vtable.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+
+// Filtering a fleet down to the recent cars, with the inheritance hierarchy
+// and dynamic_cast, and with a remote-storage Vehicle and try_as<T>().
+
+namespace inheritance {
+  struct Vehicle {
+    virtual void accelerate() = 0;
+    virtual ~Vehicle() { }
+  };
+
+  struct Car : Vehicle {
+    explicit Car(int year) : year{year} { }
+    void accelerate() override { }
+    int year;
+  };
+
+  struct Truck : Vehicle {
+    explicit Truck(int year) : year{year} { }
+    void accelerate() override { }
+    int year;
+  };
+
+  // Deeper in the hierarchy, so dynamic_cast<Car*> has more to walk through
+  struct Pickup : Truck {
+    using Truck::Truck;
+  };
+}
+
+namespace erased {
+  class Vehicle {
+    vtable const* const vptr_;
+    void* ptr_;
+
+  public:
+    template <typename Any>
+    Vehicle(Any vehicle)
+      : vptr_{&vtable_for<Any>}
+      , ptr_{new Any(std::move(vehicle))}
+    { }
+
+    Vehicle(Vehicle const& other)
+      : vptr_{other.vptr_}
+      , ptr_{other.vptr_->clone(other.ptr_)}
+    { }
+
+    template <typename T>
+    bool is() const
+    { return vptr_ == &vtable_for<T>; }
+
+    template <typename T>
+    T const* try_as() const
+    { return is<T>() ? static_cast<T const*>(ptr_) : nullptr; }
+
+    ~Vehicle()
+    { vptr_->delete_(ptr_); }
+  };
+
+  struct Car    { int year; void accelerate() { } };
+  struct Truck  { int year; void accelerate() { } };
+  struct Pickup { int year; void accelerate() { } };
+}
+
+static std::vector<int> kinds(std::size_t n) {
+  std::vector<int> k(n);
+  for (std::size_t i = 0; i != n; ++i)
+    k[i] = i % 3;
+  std::shuffle(k.begin(), k.end(), std::mt19937{42});
+  return k;
+}
+
+static void dynamic_cast_filter(benchmark::State& state) {
+  std::vector<std::unique_ptr<inheritance::Vehicle>> fleet;
+  int year = 1990;
+  for (int kind : kinds(state.range(0))) {
+    year = year == 2018 ? 1990 : year + 1;
+    if (kind == 0)      fleet.push_back(std::make_unique<inheritance::Car>(year));
+    else if (kind == 1) fleet.push_back(std::make_unique<inheritance::Truck>(year));
+    else                fleet.push_back(std::make_unique<inheritance::Pickup>(year));
+  }
+
+  for (auto _ : state) {
+    std::size_t recent_cars = 0;
+    for (auto const& vehicle : fleet) {
+      if (auto car = dynamic_cast<inheritance::Car const*>(vehicle.get()))
+        recent_cars += car->year >= 2010;
+    }
+    benchmark::DoNotOptimize(recent_cars);
+  }
+  state.SetItemsProcessed(state.iterations() * fleet.size());
+}
+
+static void try_as_filter(benchmark::State& state) {
+  std::vector<erased::Vehicle> fleet;
+  int year = 1990;
+  for (int kind : kinds(state.range(0))) {
+    year = year == 2018 ? 1990 : year + 1;
+    if (kind == 0)      fleet.push_back(erased::Car{year});
+    else if (kind == 1) fleet.push_back(erased::Truck{year});
+    else                fleet.push_back(erased::Pickup{year});
+  }
+
+  for (auto _ : state) {
+    std::size_t recent_cars = 0;
+    for (auto const& vehicle : fleet) {
+      if (auto car = vehicle.try_as<erased::Car>())
+        recent_cars += car->year >= 2010;
+    }
+    benchmark::DoNotOptimize(recent_cars);
+  }
+  state.SetItemsProcessed(state.iterations() * fleet.size());
+}
+
+BENCHMARK(dynamic_cast_filter)->Range(1 << 10, 1 << 22);
+BENCHMARK(try_as_filter)->Range(1 << 10, 1 << 22);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,142 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#include "flat_index.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+struct vtable {
+  std::string const& (*make)(void const* this_);
+  void (*move)(void* p, void* other);
+  void (*dtor)(void* this_);
+};
+
+template <typename T>
+inline constexpr vtable vtable_for = {
+  [](void const* this_) -> std::string const& {
+    return static_cast<T const*>(this_)->make;
+  },
+
+  [](void* p, void* other) {
+    new (p) T(std::move(*static_cast<T*>(other)));
+  },
+
+  [](void* this_) {
+    static_cast<T*>(this_)->~T();
+  }
+};
+
+class Vehicle {
+  vtable const* const vptr_;
+  std::aligned_storage_t<48> buffer_;
+
+public:
+  template <typename Any>
+  Vehicle(Any vehicle) : vptr_{&vtable_for<Any>} {
+    static_assert(sizeof(Any) <= sizeof(buffer_), "");
+    new (&buffer_) Any(std::move(vehicle));
+  }
+
+  Vehicle(Vehicle&& other) : vptr_{other.vptr_} {
+    other.vptr_->move(&buffer_, &other.buffer_);
+  }
+
+  std::string const& make() const
+  { return vptr_->make(&buffer_); }
+
+  ~Vehicle()
+  { vptr_->dtor(&buffer_); }
+};
+
+struct by_make {
+  std::string const& operator()(Vehicle const& v) const
+  { return v.make(); }
+};
+
+struct Car   { std::string make; int year; };
+struct Truck { std::string make; int year; };
+
+static std::vector<std::string> make_keys(std::size_t n) {
+  std::vector<std::string> keys;
+  keys.reserve(n);
+  for (std::size_t i = 0; i != n; ++i)
+    keys.push_back("make-" + std::to_string(i));
+  std::shuffle(keys.begin(), keys.end(), std::mt19937{42});
+  return keys;
+}
+
+static Vehicle make_vehicle(std::string const& key, std::size_t i) {
+  if (i % 2) return Car{key, 2017};
+  else       return Truck{key, 2015};
+}
+
+static void insert_unordered_map(benchmark::State& state) {
+  auto keys = make_keys(state.range(0));
+  for (auto _ : state) {
+    std::unordered_map<std::string, Vehicle> index;
+    index.reserve(keys.size());
+    for (std::size_t i = 0; i != keys.size(); ++i)
+      index.emplace(keys[i], make_vehicle(keys[i], i));
+    benchmark::DoNotOptimize(index.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void insert_flat_index(benchmark::State& state) {
+  auto keys = make_keys(state.range(0));
+  for (auto _ : state) {
+    flat_index<Vehicle, by_make> index{keys.size()};
+    for (std::size_t i = 0; i != keys.size(); ++i)
+      index.insert(make_vehicle(keys[i], i));
+    benchmark::DoNotOptimize(index.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void lookup_unordered_map(benchmark::State& state) {
+  auto keys = make_keys(state.range(0));
+  std::unordered_map<std::string, Vehicle> index;
+  for (std::size_t i = 0; i != keys.size(); ++i)
+    index.emplace(keys[i], make_vehicle(keys[i], i));
+  std::shuffle(keys.begin(), keys.end(), std::mt19937{43});
+
+  for (auto _ : state) {
+    for (auto const& key : keys)
+      benchmark::DoNotOptimize(&index.find(key)->second);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void lookup_flat_index(benchmark::State& state) {
+  auto keys = make_keys(state.range(0));
+  flat_index<Vehicle, by_make> index;
+  for (std::size_t i = 0; i != keys.size(); ++i)
+    index.insert(make_vehicle(keys[i], i));
+  std::shuffle(keys.begin(), keys.end(), std::mt19937{43});
+
+  for (auto _ : state) {
+    for (auto const& key : keys)
+      benchmark::DoNotOptimize(index.find(key));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// 1M to 16M entries; larger fleets only change the constant of the cache
+// misses, and would need tens of GB of memory for the unordered_map.
+BENCHMARK(insert_unordered_map)->RangeMultiplier(4)->Range(1 << 20, 1 << 24)->Unit(benchmark::kMillisecond);
+BENCHMARK(insert_flat_index)->RangeMultiplier(4)->Range(1 << 20, 1 << 24)->Unit(benchmark::kMillisecond);
+BENCHMARK(lookup_unordered_map)->RangeMultiplier(4)->Range(1 << 20, 1 << 24)->Unit(benchmark::kMillisecond);
+BENCHMARK(lookup_flat_index)->RangeMultiplier(4)->Range(1 << 20, 1 << 24)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
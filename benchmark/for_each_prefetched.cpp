@@ -0,0 +1,115 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#include "for_each_prefetched.hpp"
+#include "vtable.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+
+class Vehicle {
+  vtable const* vptr_;
+  void* ptr_;
+
+public:
+  template <typename Any>
+  Vehicle(Any vehicle)
+    : vptr_{&vtable_for<Any>}
+    , ptr_{new Any(std::move(vehicle))}
+  { }
+
+  Vehicle(Vehicle&& other)
+    : vptr_{other.vptr_}
+    , ptr_{std::exchange(other.ptr_, nullptr)}
+  { }
+
+  Vehicle& operator=(Vehicle&& other) {
+    std::swap(vptr_, other.vptr_);
+    std::swap(ptr_, other.ptr_);
+    return *this;
+  }
+
+  void accelerate()
+  { vptr_->accelerate(ptr_); }
+
+  void prefetch() const {
+    ::prefetch(vptr_);
+    ::prefetch(ptr_);
+  }
+
+  ~Vehicle()
+  { if (ptr_) vptr_->delete_(ptr_); }
+};
+
+class SharedVehicle {
+  vtable const* vptr_;
+  std::shared_ptr<void> ptr_;
+
+public:
+  template <typename Any>
+  SharedVehicle(Any vehicle)
+    : vptr_{&vtable_for<Any>}
+    , ptr_{std::make_shared<Any>(std::move(vehicle))}
+  { }
+
+  void accelerate()
+  { vptr_->accelerate(ptr_.get()); }
+
+  void prefetch() const {
+    ::prefetch(vptr_);
+    ::prefetch(ptr_.get());
+  }
+};
+
+// One cache line per payload
+struct Car   { long speed; char pad[56]; void accelerate() { speed += 1; } };
+struct Truck { long speed; char pad[56]; void accelerate() { speed += 2; } };
+struct Plane { long speed; char pad[56]; void accelerate() { speed += 3; } };
+
+// Payloads are allocated in order and the handles are then shuffled, so that
+// iterating the handles visits the heap in random order.
+template <typename Handle>
+static std::vector<Handle> make_fleet(std::size_t n) {
+  std::vector<Handle> fleet;
+  fleet.reserve(n);
+  for (std::size_t i = 0; i != n; ++i) {
+    switch (i % 3) {
+      case 0: fleet.push_back(Car{}); break;
+      case 1: fleet.push_back(Truck{}); break;
+      case 2: fleet.push_back(Plane{}); break;
+    }
+  }
+  std::shuffle(fleet.begin(), fleet.end(), std::mt19937{42});
+  return fleet;
+}
+
+template <typename Handle>
+static void iterate(benchmark::State& state) {
+  auto fleet = make_fleet<Handle>(state.range(0));
+  std::size_t const distance = state.range(1);
+  for (auto _ : state) {
+    for_each_prefetched(fleet, &Handle::accelerate, distance);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * fleet.size());
+}
+
+// 2^16 payloads fit in the caches; 2^23 payloads take 512MB, which is larger
+// than the last level cache of most machines.
+static void distances(benchmark::internal::Benchmark* b) {
+  for (int n : {1 << 16, 1 << 23})
+    for (int distance : {0, 1, 2, 4, 8, 16, 32, 64})
+      b->Args({n, distance});
+}
+
+BENCHMARK_TEMPLATE(iterate, Vehicle)->Apply(distances);
+BENCHMARK_TEMPLATE(iterate, SharedVehicle)->Apply(distances);
+
+BENCHMARK_MAIN();
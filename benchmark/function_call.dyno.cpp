@@ -0,0 +1,86 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// Calling type-erased callables in a tight loop, with std::function and with
+// the wrappers of functions.hpp, where the `call` function pointer is
+// either stored inline in the object or looked up in a remote vtable.
+
+#include "functions.hpp"
+
+#include <benchmark/benchmark.h>
+#include <dyno.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <vector>
+
+
+// function and inplace_function store the `call` pointer inline; these are
+// the same wrappers with the whole vtable stored remotely, as before.
+template <typename Signature>
+using remote_function = basic_function<Signature, dyno::sbo_storage<16>>;
+
+template <typename Signature>
+using remote_inplace_function = basic_function<Signature, dyno::local_storage<32>>;
+
+
+//////////////////////////////////////////////////////////////////////////////
+// A few different callables in random order, so the indirect call is not
+// trivially predicted.
+template <typename Function>
+std::vector<Function> make_handlers(std::size_t n) {
+  std::mt19937 gen{42};
+  std::uniform_int_distribution<int> kinds{0, 3};
+  std::vector<Function> handlers;
+  handlers.reserve(n);
+  for (std::size_t i = 0; i != n; ++i) {
+    int k = static_cast<int>(i);
+    switch (kinds(gen)) {
+      case 0: handlers.emplace_back([](int x) { return x + 1; }); break;
+      case 1: handlers.emplace_back([k](int x) { return x * k; }); break;
+      case 2: handlers.emplace_back([k](int x) { return x ^ k; }); break;
+      default: handlers.emplace_back([](int x) { return x - 1; }); break;
+    }
+  }
+  return handlers;
+}
+
+template <typename Function>
+void call(benchmark::State& state) {
+  auto handlers = make_handlers<Function>(state.range(0));
+  for (auto _ : state) {
+    int sum = 0;
+    for (auto const& f : handlers)
+      sum += f(sum);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * handlers.size());
+}
+
+// The same callable over and over, where only the cost of the call remains
+template <typename Function>
+void call_one(benchmark::State& state) {
+  Function f = [](int x) { return x + 1; };
+  int x = 0;
+  for (auto _ : state) {
+    for (int i = 0; i != 1000; ++i)
+      x = f(x);
+    benchmark::DoNotOptimize(x);
+  }
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+BENCHMARK_TEMPLATE(call, std::function<int(int)>)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(call, remote_function<int(int)>)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(call, function<int(int)>)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(call, remote_inplace_function<int(int)>)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(call, inplace_function<int(int)>)->Arg(1 << 10)->Arg(1 << 20);
+
+BENCHMARK_TEMPLATE(call_one, std::function<int(int)>);
+BENCHMARK_TEMPLATE(call_one, remote_function<int(int)>);
+BENCHMARK_TEMPLATE(call_one, function<int(int)>);
+BENCHMARK_TEMPLATE(call_one, remote_inplace_function<int(int)>);
+BENCHMARK_TEMPLATE(call_one, inplace_function<int(int)>);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,202 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// Accelerating a fleet whose payloads have a few hot fields next to large
+// cold ones, with the whole payload on the heap, the whole payload inline in
+// a large buffer, and the hot/cold split of hot_cold_storage.cpp, where only
+// the hot fields are inline.
+
+#include "vtable.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// Whole payloads
+struct Car {
+  int year; int speed;
+  std::string make; std::string model;
+  void accelerate() { speed += 1; }
+};
+struct Truck {
+  int year; int speed;
+  std::string make; std::string model;
+  void accelerate() { speed += 2; }
+};
+struct Plane {
+  int year; int speed;
+  std::string make; std::string model;
+  void accelerate() { speed += 3; }
+};
+
+class RemoteVehicle {
+  vtable const* vptr_;
+  void* ptr_;
+
+public:
+  template <typename Any>
+  RemoteVehicle(Any vehicle)
+    : vptr_{&vtable_for<Any>}
+    , ptr_{new Any(std::move(vehicle))}
+  { }
+
+  RemoteVehicle(RemoteVehicle&& other)
+    : vptr_{other.vptr_}
+    , ptr_{std::exchange(other.ptr_, nullptr)}
+  { }
+
+  RemoteVehicle& operator=(RemoteVehicle&& other) {
+    std::swap(vptr_, other.vptr_);
+    std::swap(ptr_, other.ptr_);
+    return *this;
+  }
+
+  void accelerate()
+  { vptr_->accelerate(ptr_); }
+
+  ~RemoteVehicle()
+  { if (ptr_) vptr_->delete_(ptr_); }
+};
+
+class LocalVehicle {
+  vtable const* vptr_;
+  std::aligned_storage_t<sizeof(Car), alignof(Car)> buffer_;
+
+public:
+  template <typename Any>
+  LocalVehicle(Any vehicle) : vptr_{&vtable_for<Any>} {
+    static_assert(sizeof(Any) <= sizeof(buffer_), "");
+    new (&buffer_) Any(std::move(vehicle));
+  }
+
+  LocalVehicle(LocalVehicle&& other) : vptr_{other.vptr_}
+  { vptr_->move(&buffer_, &other.buffer_); }
+
+  LocalVehicle& operator=(LocalVehicle&& other) {
+    vptr_->dtor(&buffer_);
+    vptr_ = other.vptr_;
+    vptr_->move(&buffer_, &other.buffer_);
+    return *this;
+  }
+
+  void accelerate()
+  { vptr_->accelerate(&buffer_); }
+
+  ~LocalVehicle()
+  { vptr_->dtor(&buffer_); }
+};
+
+
+// Split payloads
+struct hot { int year; int speed; };
+struct cold { std::string make; std::string model; };
+
+struct SplitCar   { using hot = ::hot; using cold = ::cold; static void accelerate(hot& h) { h.speed += 1; } };
+struct SplitTruck { using hot = ::hot; using cold = ::cold; static void accelerate(hot& h) { h.speed += 2; } };
+struct SplitPlane { using hot = ::hot; using cold = ::cold; static void accelerate(hot& h) { h.speed += 3; } };
+
+struct split_vtable {
+  void (*accelerate)(void* hot, void* cold);
+  void (*move)(void* hot, void* other_hot);
+  void (*destroy)(void* hot, void* cold);
+};
+
+template <typename T>
+inline constexpr split_vtable split_vtable_for = {
+  [](void* hot, void*) {
+    T::accelerate(*static_cast<typename T::hot*>(hot));
+  },
+  [](void* hot, void* other_hot) {
+    using Hot = typename T::hot;
+    new (hot) Hot(std::move(*static_cast<Hot*>(other_hot)));
+  },
+  [](void* hot, void* cold) {
+    using Hot = typename T::hot;
+    static_cast<Hot*>(hot)->~Hot();
+    delete static_cast<typename T::cold*>(cold);
+  }
+};
+
+class HotColdVehicle {
+  split_vtable const* vptr_;
+  void* cold_;
+  std::aligned_storage_t<16, alignof(void*)> hot_;
+
+public:
+  template <typename Any>
+  HotColdVehicle(Any, typename Any::hot hot, typename Any::cold cold)
+    : vptr_{&split_vtable_for<Any>}, cold_{new typename Any::cold(std::move(cold))}
+  { new (&hot_) typename Any::hot(std::move(hot)); }
+
+  HotColdVehicle(HotColdVehicle&& other)
+    : vptr_{other.vptr_}, cold_{std::exchange(other.cold_, nullptr)}
+  { vptr_->move(&hot_, &other.hot_); }
+
+  HotColdVehicle& operator=(HotColdVehicle&& other) {
+    vptr_->destroy(&hot_, cold_);
+    vptr_ = other.vptr_;
+    cold_ = std::exchange(other.cold_, nullptr);
+    vptr_->move(&hot_, &other.hot_);
+    return *this;
+  }
+
+  void accelerate()
+  { vptr_->accelerate(&hot_, cold_); }
+
+  ~HotColdVehicle()
+  { vptr_->destroy(&hot_, cold_); }
+};
+
+
+// Payloads are allocated in order and the handles are then shuffled, so that
+// iterating the handles visits the heap in random order.
+template <typename Handle>
+std::vector<Handle> make_fleet(std::size_t n) {
+  std::string const make = "A manufacturer with a long name";
+  std::string const model = "A model with an even longer name";
+  std::vector<Handle> fleet;
+  fleet.reserve(n);
+  for (std::size_t i = 0; i != n; ++i) {
+    if constexpr (std::is_same<Handle, HotColdVehicle>::value) {
+      switch (i % 3) {
+        case 0: fleet.emplace_back(SplitCar{}, hot{2017, 0}, cold{make, model}); break;
+        case 1: fleet.emplace_back(SplitTruck{}, hot{2015, 0}, cold{make, model}); break;
+        case 2: fleet.emplace_back(SplitPlane{}, hot{1969, 0}, cold{make, model}); break;
+      }
+    } else {
+      switch (i % 3) {
+        case 0: fleet.emplace_back(Car{2017, 0, make, model}); break;
+        case 1: fleet.emplace_back(Truck{2015, 0, make, model}); break;
+        case 2: fleet.emplace_back(Plane{1969, 0, make, model}); break;
+      }
+    }
+  }
+  std::shuffle(fleet.begin(), fleet.end(), std::mt19937{42});
+  return fleet;
+}
+
+template <typename Handle>
+void accelerate(benchmark::State& state) {
+  auto fleet = make_fleet<Handle>(state.range(0));
+  for (auto _ : state) {
+    for (auto& vehicle : fleet)
+      vehicle.accelerate();
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * fleet.size());
+  state.counters["handle_bytes"] = sizeof(Handle);
+}
+
+BENCHMARK_TEMPLATE(accelerate, RemoteVehicle)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(accelerate, LocalVehicle)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(accelerate, HotColdVehicle)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 20);
+
+BENCHMARK_MAIN();
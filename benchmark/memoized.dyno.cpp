@@ -0,0 +1,102 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// A read-heavy mix of an expensive const query and a mutating call, with a
+// plain dyno::poly and with the memoizing_poly of memoizing_poly.hpp, which
+// only dispatches the query again after a mutation.
+
+#include "memoizing_poly.hpp"
+
+#include <benchmark/benchmark.h>
+#include <dyno.hpp>
+
+#include <array>
+#include <cstddef>
+#include <numeric>
+#include <utility>
+#include <vector>
+using namespace dyno::literals;
+
+
+struct IVehicle : decltype(dyno::requires(
+  dyno::CopyConstructible{},
+  dyno::Destructible{},
+  "accelerate"_s = dyno::function<void(dyno::T&)>,
+  "is_stopped"_s = dyno::function<bool(dyno::T const&)>
+)) { };
+
+template <typename T>
+constexpr auto dyno::default_concept_map<IVehicle, T> = dyno::make_concept_map(
+  "accelerate"_s = [](T& vehicle) { vehicle.accelerate(); },
+  "is_stopped"_s = [](T const& vehicle) { return vehicle.is_stopped(); }
+);
+
+// Number of times a query actually reached a vehicle
+long dispatched_queries = 0;
+
+// The query looks at every wheel, so it costs more than the dispatch
+template <int Wheels>
+struct Vehicle {
+  std::array<int, 4 * Wheels> speeds{};
+  void accelerate() { ++speeds[0]; }
+  bool is_stopped() const {
+    ++dispatched_queries;
+    return std::accumulate(speeds.begin(), speeds.end(), 0) == 0;
+  }
+};
+using Car = Vehicle<4>;
+using Truck = Vehicle<6>;
+using Bike = Vehicle<2>;
+
+struct Plain {
+  template <typename Any>
+  Plain(Any vehicle) : poly_{std::move(vehicle)} { }
+  void accelerate() { poly_.virtual_("accelerate"_s)(poly_); }
+  bool is_stopped() const { return poly_.virtual_("is_stopped"_s)(poly_); }
+private:
+  dyno::poly<IVehicle, dyno::remote_storage> poly_;
+};
+
+struct Memoized {
+  template <typename Any>
+  Memoized(Any vehicle) : poly_{std::move(vehicle)} { }
+  void accelerate() { poly_.call("accelerate"_s); }
+  bool is_stopped() const { return poly_.call("is_stopped"_s); }
+private:
+  memoizing_poly<IVehicle, dyno::remote_storage,
+                 memoize<decltype("is_stopped"_s)>> poly_;
+};
+
+// Every vehicle is queried state.range(0) times for each time it accelerates
+template <typename Handle>
+void read_heavy(benchmark::State& state) {
+  std::vector<Handle> vehicles;
+  for (int i = 0; i != 1000; ++i) {
+    switch (i % 3) {
+      case 0: vehicles.emplace_back(Car{}); break;
+      case 1: vehicles.emplace_back(Truck{}); break;
+      default: vehicles.emplace_back(Bike{}); break;
+    }
+  }
+  long const reads = state.range(0);
+
+  dispatched_queries = 0;
+  for (auto _ : state) {
+    int stopped = 0;
+    for (auto& vehicle : vehicles) {
+      Handle const& query = vehicle;
+      for (long r = 0; r != reads; ++r)
+        stopped += query.is_stopped();
+      vehicle.accelerate();
+    }
+    benchmark::DoNotOptimize(stopped);
+  }
+  state.SetItemsProcessed(state.iterations() * vehicles.size() * (reads + 1));
+  state.counters["dispatched_queries"] = benchmark::Counter(
+    static_cast<double>(dispatched_queries) / (state.iterations() * vehicles.size() * reads));
+}
+
+BENCHMARK_TEMPLATE(read_heavy, Plain)->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK_TEMPLATE(read_heavy, Memoized)->Arg(1)->Arg(10)->Arg(100);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,210 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// Memory footprint of every storage policy, as opposed to its speed. For
+// each policy and payload size, this builds a fleet, churns it by replacing
+// a random half of the vehicles (so the heap gets fragmented like it would
+// in a long-running process), and reports:
+//
+//    handle bytes      sizeof(Vehicle)
+//    heap bytes/obj    bytes requested from operator new per vehicle
+//    allocs/obj        number of live heap allocations per vehicle
+//    slack bytes/obj   bytes the allocator hands out beyond what was asked,
+//                      plus its per-chunk header (glibc only)
+//    RSS bytes/obj     growth of the resident set size, per vehicle
+//
+// Memory freed by one benchmark stays cached in the allocator and lowers the
+// RSS growth of the next one, so the RSS figures are only reliable when a
+// single benchmark is run at a time with --benchmark_filter.
+//
+// The handles are the ones of code/*.hpp. local_storage's buffer is 64
+// bytes, so it is only measured with payloads that fit.
+//
+// The timings are meaningless here; look at the counters. The fleet size
+// defaults to 10M and can be changed with the first argument of each
+// benchmark, e.g. --benchmark_filter='/1000000$'.
+
+#include "local_storage.hpp"
+#include "remote_storage.hpp"
+#include "sbo_storage.hpp"
+#include "shared_remote_storage.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <utility>
+#include <vector>
+
+#if defined(__GLIBC__)
+#  include <malloc.h>
+#endif
+#if defined(__linux__)
+#  include <unistd.h>
+#endif
+
+
+//////////////////////////////////////////////////////////////////////////////
+// Counting allocator, installed by replacing the global operator new/delete.
+// The counters track live allocations, so they can be sampled before and
+// after building a fleet. Each allocation is prefixed by a header holding
+// its requested size, so that unsized deletes can be accounted for too.
+namespace heap {
+  std::size_t bytes = 0;       // bytes requested by live allocations
+  std::size_t allocations = 0; // number of live allocations
+  std::size_t usable = 0;      // bytes reserved by the allocator for them
+
+  constexpr std::size_t header = alignof(std::max_align_t);
+
+  // Bytes reserved for a chunk, without our own header but with the
+  // allocator's, which sits right before the pointer it returns.
+  inline std::size_t reserved(void* chunk, std::size_t requested) {
+#if defined(__GLIBC__)
+    (void)requested;
+    return ::malloc_usable_size(chunk) + sizeof(std::size_t) - header;
+#else
+    (void)chunk;
+    return requested;
+#endif
+  }
+
+  struct snapshot {
+    std::size_t bytes = heap::bytes;
+    std::size_t allocations = heap::allocations;
+    std::size_t usable = heap::usable;
+  };
+}
+
+void* operator new(std::size_t n) {
+  void* chunk = std::malloc(heap::header + n);
+  if (chunk == nullptr)
+    throw std::bad_alloc{};
+  *static_cast<std::size_t*>(chunk) = n;
+  heap::bytes += n;
+  heap::allocations += 1;
+  heap::usable += heap::reserved(chunk, n);
+  return static_cast<char*>(chunk) + heap::header;
+}
+
+void operator delete(void* p) noexcept {
+  if (p == nullptr)
+    return;
+  void* chunk = static_cast<char*>(p) - heap::header;
+  std::size_t n = *static_cast<std::size_t*>(chunk);
+  heap::bytes -= n;
+  heap::allocations -= 1;
+  heap::usable -= heap::reserved(chunk, n);
+  std::free(chunk);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  ::operator delete(p);
+}
+
+// Resident set size of the process, in bytes
+static std::size_t resident_bytes() {
+#if defined(__linux__)
+  std::size_t pages = 0, resident = 0;
+  if (std::FILE* statm = std::fopen("/proc/self/statm", "r")) {
+    if (std::fscanf(statm, "%zu %zu", &pages, &resident) != 2)
+      resident = 0;
+    std::fclose(statm);
+  }
+  return resident * static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+#else
+  return 0;
+#endif
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+// Payloads of `Size` bytes
+template <std::size_t Size>
+struct Car   { int speed; char pad[Size - sizeof(int)]; void accelerate() { speed += 1; } };
+template <std::size_t Size>
+struct Truck { int speed; char pad[Size - sizeof(int)]; void accelerate() { speed += 2; } };
+template <std::size_t Size>
+struct Plane { int speed; char pad[Size - sizeof(int)]; void accelerate() { speed += 3; } };
+
+template <typename Vehicle, std::size_t Size>
+void emplace(Vehicle* where, int kind) {
+  if (kind == 0)      new (where) Vehicle(Car<Size>{});
+  else if (kind == 1) new (where) Vehicle(Truck<Size>{});
+  else                new (where) Vehicle(Plane<Size>{});
+}
+
+template <typename Vehicle, std::size_t Size>
+void footprint(benchmark::State& state) {
+  std::size_t const n = state.range(0);
+  std::mt19937 gen{42};
+  std::uniform_int_distribution<int> kinds{0, 2};
+
+  for (auto _ : state) {
+    heap::snapshot const heap_before;
+    std::size_t const rss_before = resident_bytes();
+    {
+      std::vector<Vehicle> fleet;
+      fleet.reserve(n);
+      for (std::size_t i = 0; i != n; ++i) {
+        int kind = kinds(gen);
+        if (kind == 0)      fleet.emplace_back(Car<Size>{});
+        else if (kind == 1) fleet.emplace_back(Truck<Size>{});
+        else                fleet.emplace_back(Plane<Size>{});
+      }
+
+      // Churn: replace a random half of the fleet, so that the heap ends up
+      // interleaving allocations of different ages.
+      std::vector<std::size_t> victims(n);
+      for (std::size_t i = 0; i != n; ++i)
+        victims[i] = i;
+      std::shuffle(victims.begin(), victims.end(), gen);
+      victims.resize(n / 2);
+      for (std::size_t i : victims)
+        fleet[i].~Vehicle();
+      for (std::size_t i : victims)
+        emplace<Vehicle, Size>(&fleet[i], kinds(gen));
+      decltype(victims){}.swap(victims);
+
+      heap::snapshot const heap_after;
+      std::size_t const rss_after = resident_bytes();
+      double const objects = static_cast<double>(n);
+      // The fleet's own buffer is sizeof(Vehicle) * n, and is not counted
+      // as heap bytes per object.
+      std::size_t const buffer = sizeof(Vehicle) * n;
+      state.counters["handle bytes"] = sizeof(Vehicle);
+      state.counters["heap bytes/obj"] = (heap_after.bytes - heap_before.bytes - buffer) / objects;
+      state.counters["allocs/obj"] = (heap_after.allocations - heap_before.allocations - 1) / objects;
+      state.counters["slack bytes/obj"] =
+        ((heap_after.usable - heap_before.usable) - (heap_after.bytes - heap_before.bytes)) / objects;
+      state.counters["RSS bytes/obj"] =
+        rss_after > rss_before ? (rss_after - rss_before) / objects : 0;
+      benchmark::DoNotOptimize(fleet.data());
+    }
+  }
+}
+
+constexpr long fleet_size = 10'000'000;
+
+#define FOOTPRINT_BENCHMARK(VEHICLE, SIZE) \
+  BENCHMARK_TEMPLATE(footprint, VEHICLE, SIZE)->Arg(fleet_size)->Iterations(1)->Unit(benchmark::kMillisecond)
+
+#define FOOTPRINT_BENCHMARKS(SIZE)                            \
+  FOOTPRINT_BENCHMARK(remote_storage::Vehicle, SIZE);         \
+  FOOTPRINT_BENCHMARK(sbo_storage::Vehicle<16>, SIZE);        \
+  FOOTPRINT_BENCHMARK(sbo_storage::Vehicle<32>, SIZE);        \
+  FOOTPRINT_BENCHMARK(sbo_storage::Vehicle<64>, SIZE);        \
+  FOOTPRINT_BENCHMARK(shared_remote_storage::Vehicle, SIZE)
+
+FOOTPRINT_BENCHMARKS(8);
+FOOTPRINT_BENCHMARKS(32);
+FOOTPRINT_BENCHMARKS(64);
+FOOTPRINT_BENCHMARKS(128);
+FOOTPRINT_BENCHMARK(local_storage::Vehicle, 8);
+FOOTPRINT_BENCHMARK(local_storage::Vehicle, 32);
+FOOTPRINT_BENCHMARK(local_storage::Vehicle, 64);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,146 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// Calling methods by a name only known at runtime, as a scripting layer does,
+// with a chain of string comparisons, with a std::unordered_map from names to
+// indices, and with the perfect hash of method_table.hpp. All of them call
+// the method through invoke_packed, with one argument, like
+// Vehicle::invoke(name, args...) in code/named_dispatch.cpp, so that the
+// signature checks and the packing of the arguments are included and only
+// the lookup differs.
+
+#include "method_table.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+// Sixteen commands, which is what a scripting interface to a vehicle would
+// expose; with only a few methods, a chain of comparisons is hard to beat.
+constexpr std::string_view names[] = {
+  "accelerate", "brake", "turn_left", "turn_right", "honk", "refuel",
+  "start", "stop", "park", "lock", "unlock", "open_trunk", "close_trunk",
+  "headlights_on", "headlights_off", "wipe"
+};
+constexpr std::size_t command_count = sizeof(names) / sizeof(names[0]);
+
+template <std::size_t ...I>
+constexpr auto make_methods(std::index_sequence<I...>) {
+  return method_table{
+    method<void(int)>(names[I], [](auto& self, int x) { self.template command<I>(x); })...
+  };
+}
+
+constexpr auto vehicle_methods = make_methods(std::make_index_sequence<command_count>{});
+
+struct vtable {
+  std::array<invoker, command_count> methods;
+  void (*delete_)(void* this_);
+};
+
+template <typename T>
+inline constexpr vtable vtable_for = {
+  invokers_for<vehicle_methods, T>,
+  [](void* this_) { delete static_cast<T*>(this_); }
+};
+
+template <int N>
+struct Vehicle {
+  int state_ = 0;
+  template <std::size_t Command>
+  void command(int x) { state_ += N * Command + x; }
+};
+using Car = Vehicle<1>;
+using Truck = Vehicle<2>;
+using Plane = Vehicle<3>;
+
+// if (name == "accelerate") return 0; else if (name == "brake") return 1; ...
+template <std::size_t ...I>
+std::size_t compare_each(std::string_view name, std::index_sequence<I...>) {
+  std::size_t i = vehicle_methods.npos;
+  (void)((name == names[I] ? (i = I, true) : false) || ...);
+  return i;
+}
+
+struct StringCompares {
+  static std::size_t find(std::string_view name)
+  { return compare_each(name, std::make_index_sequence<command_count>{}); }
+};
+
+template <std::size_t ...I>
+std::unordered_map<std::string, std::size_t> make_registry(std::index_sequence<I...>)
+{ return {{std::string{names[I]}, I}...}; }
+
+struct Registry {
+  static inline std::unordered_map<std::string, std::size_t> const indices =
+    make_registry(std::make_index_sequence<command_count>{});
+
+  static std::size_t find(std::string_view name) {
+    auto it = indices.find(std::string{name});
+    return it == indices.end() ? vehicle_methods.npos : it->second;
+  }
+};
+
+struct PerfectHash {
+  static std::size_t find(std::string_view name)
+  { return vehicle_methods.find(name); }
+};
+
+// The Vehicle of code/named_dispatch.cpp, with the lookup as a parameter
+template <typename Lookup>
+struct Handle {
+  vtable const* vptr_;
+  void* ptr_;
+
+  template <typename Any>
+  Handle(Any vehicle) : vptr_{&vtable_for<Any>}, ptr_{new Any(vehicle)} { }
+  Handle(Handle&& other) : vptr_{other.vptr_}, ptr_{std::exchange(other.ptr_, nullptr)} { }
+  ~Handle()
+  { if (ptr_) vptr_->delete_(ptr_); }
+
+  template <typename R = void, typename ...Args>
+  R invoke(std::string_view name, Args&& ...args) {
+    return invoke_packed<R>(vehicle_methods, vptr_->methods.data(), Lookup::find(name),
+                            ptr_, std::forward<Args>(args)...);
+  }
+};
+
+// Every vehicle gets a method called on it, whose name is picked at random,
+// with an lvalue argument, which is copied since the method takes it by
+// value. The names are copied into strings, as if they came from a script.
+template <typename Lookup>
+void invoke_by_name(benchmark::State& state) {
+  std::vector<Handle<Lookup>> vehicles;
+  std::vector<std::string> commands;
+  std::mt19937 gen{42};
+  for (int i = 0; i != 1000; ++i) {
+    switch (i % 3) {
+      case 0: vehicles.emplace_back(Car{}); break;
+      case 1: vehicles.emplace_back(Truck{}); break;
+      default: vehicles.emplace_back(Plane{}); break;
+    }
+    commands.emplace_back(names[gen() % command_count]);
+  }
+
+  int x = 1;
+  for (auto _ : state) {
+    for (std::size_t i = 0; i != vehicles.size(); ++i)
+      vehicles[i].invoke(commands[i], x);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * vehicles.size());
+}
+
+BENCHMARK_TEMPLATE(invoke_by_name, StringCompares);
+BENCHMARK_TEMPLATE(invoke_by_name, Registry);
+BENCHMARK_TEMPLATE(invoke_by_name, PerfectHash);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,82 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#include "local_storage.hpp"
+#include "parallel_for_each.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <thread>
+#include <vector>
+using local_storage::Vehicle;
+
+
+struct Car   { int speed; void accelerate() { speed += 1; } };
+struct Truck { int speed; void accelerate() { speed += 2; } };
+struct Plane { int speed; void accelerate() { speed += 3; } };
+
+static std::vector<Vehicle> make_fleet(std::size_t n) {
+  std::vector<int> kinds(n);
+  for (std::size_t i = 0; i != n; ++i)
+    kinds[i] = i % 3;
+  std::shuffle(kinds.begin(), kinds.end(), std::mt19937{42});
+
+  std::vector<Vehicle> fleet;
+  fleet.reserve(n);
+  for (int kind : kinds) {
+    if (kind == 0)      fleet.push_back(Car{0});
+    else if (kind == 1) fleet.push_back(Truck{0});
+    else                fleet.push_back(Plane{0});
+  }
+  return fleet;
+}
+
+static void sequential(benchmark::State& state) {
+  auto fleet = make_fleet(state.range(0));
+  for (auto _ : state) {
+    for (auto& vehicle : fleet)
+      vehicle.accelerate();
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * fleet.size());
+}
+
+static void parallel(benchmark::State& state) {
+  auto fleet = make_fleet(state.range(0));
+  thread_pool pool{static_cast<std::size_t>(state.range(1))};
+  for (auto _ : state) {
+    parallel_for_each(pool, fleet, &Vehicle::accelerate);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * fleet.size());
+}
+
+static void parallel_grouped(benchmark::State& state) {
+  auto fleet = make_fleet(state.range(0));
+  thread_pool pool{static_cast<std::size_t>(state.range(1))};
+  for (auto _ : state) {
+    parallel_for_each(pool, fleet, &Vehicle::accelerate,
+                      [](Vehicle const& v) { return v.vptr(); });
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * fleet.size());
+}
+
+static void threads(benchmark::internal::Benchmark* b) {
+  int const cores = std::max(1u, std::thread::hardware_concurrency());
+  for (int n : {1 << 16, 1 << 22})
+    for (int t = 1; t <= cores; t *= 2)
+      b->Args({n, t});
+  if ((cores & (cores - 1)) != 0)
+    for (int n : {1 << 16, 1 << 22})
+      b->Args({n, cores});
+}
+
+BENCHMARK(sequential)->Arg(1 << 16)->Arg(1 << 22);
+BENCHMARK(parallel)->Apply(threads)->UseRealTime();
+BENCHMARK(parallel_grouped)->Apply(threads)->UseRealTime();
+
+BENCHMARK_MAIN();
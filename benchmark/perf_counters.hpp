@@ -0,0 +1,120 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#ifndef BENCHMARK_PERF_COUNTERS_HPP
+#define BENCHMARK_PERF_COUNTERS_HPP
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__linux__)
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#  include <cstring>
+#endif
+
+
+#if defined(__linux__)
+namespace detail {
+  // Read misses in the given cache
+  constexpr std::uint64_t cache_misses(std::uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                 | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  }
+}
+#endif
+
+
+// Hardware performance counters for the calling thread, read through Linux's
+// perf_event_open. Counters that can't be opened (unsupported by the CPU,
+// running in a VM, or restricted by /proc/sys/kernel/perf_event_paranoid)
+// are silently left out of the report, and nothing is reported on other
+// platforms.
+//
+// Usage:
+//    perf_counters counters;
+//    for (auto _ : state) { ... }
+//    counters.report(state, number_of_dispatches);
+//
+// Each counter is reported in `state.counters` divided by the number of
+// operations, e.g. `branch-misses/op`.
+class perf_counters {
+public:
+  static constexpr std::size_t max_events = 5;
+
+#if defined(__linux__)
+private:
+  struct event {
+    char const* name;
+    std::uint32_t type;
+    std::uint64_t config;
+  };
+
+  static constexpr event events[max_events] = {
+    {"instructions/op",  PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"branch-misses/op", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {"L1d-misses/op",    PERF_TYPE_HW_CACHE, detail::cache_misses(PERF_COUNT_HW_CACHE_L1D)},
+    {"LLC-misses/op",    PERF_TYPE_HW_CACHE, detail::cache_misses(PERF_COUNT_HW_CACHE_LL)},
+    {"iTLB-misses/op",   PERF_TYPE_HW_CACHE, detail::cache_misses(PERF_COUNT_HW_CACHE_ITLB)},
+  };
+
+  int fds_[max_events];
+
+  static int open(event const& e) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = e.type;
+    attr.config = e.config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+
+public:
+  perf_counters() {
+    for (std::size_t i = 0; i != max_events; ++i)
+      fds_[i] = open(events[i]);
+    for (int fd : fds_)
+      if (fd >= 0)
+        ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+
+  perf_counters(perf_counters const&) = delete;
+  perf_counters& operator=(perf_counters const&) = delete;
+
+  ~perf_counters() {
+    for (int fd : fds_)
+      if (fd >= 0)
+        ::close(fd);
+  }
+
+  void report(benchmark::State& state, double operations) {
+    for (int fd : fds_)
+      if (fd >= 0)
+        ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+    for (std::size_t i = 0; i != max_events; ++i) {
+      // value, time enabled, time running
+      std::uint64_t values[3];
+      if (fds_[i] < 0 || ::read(fds_[i], values, sizeof(values)) != sizeof(values) ||
+          values[2] == 0)
+        continue;
+      // scale the count up when the kernel had to multiplex counters
+      double count = static_cast<double>(values[0]) * values[1] / values[2];
+      state.counters[events[i].name] = count / operations;
+    }
+  }
+
+#else
+  void report(benchmark::State&, double) { }
+#endif
+};
+
+#endif // header guard
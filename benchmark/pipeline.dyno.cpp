@@ -0,0 +1,96 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// Pushing elements through parse -> filter -> transform -> sink, either as a
+// chain of functions called on every element, or with the pipeline of
+// pipeline.hpp, where stages are erased and called once per batch, or fused
+// into a single loop.
+
+#include "functions.hpp"
+#include "pipeline.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+
+std::vector<std::uint32_t> make_input(std::size_t n) {
+  std::mt19937 gen{42};
+  std::vector<std::uint32_t> input(n);
+  for (auto& x : input)
+    x = gen();
+  return input;
+}
+
+auto parse = [](std::uint32_t raw) { return static_cast<int>(raw >> 8); };
+auto keep = [](int x) { return x % 3 != 0; };
+auto transform = [](int x) { return x * 7 + 1; };
+
+// One indirect call per stage per element
+static void per_element(benchmark::State& state) {
+  auto const input = make_input(state.range(0));
+  long sum = 0;
+  function<int(std::uint32_t)> parse_f = parse;
+  function<bool(int)> keep_f = keep;
+  function<int(int)> transform_f = transform;
+  function<void(int)> sink_f = [&sum](int x) { sum += x; };
+
+  for (auto _ : state) {
+    for (auto raw : input) {
+      int x = parse_f(raw);
+      if (keep_f(x))
+        sink_f(transform_f(x));
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+}
+
+// One indirect call per stage per batch
+template <std::size_t BatchSize>
+static void batched(benchmark::State& state) {
+  auto const input = make_input(state.range(0));
+  long sum = 0;
+  auto p = make_pipeline<std::uint32_t, BatchSize>()
+             .then(erase<std::uint32_t>(map(parse)))
+             .then(erase<int>(filter(keep)))
+             .then(erase<int>(map(transform)))
+             .sink([&sum](int x) { sum += x; });
+
+  for (auto _ : state) {
+    for (auto raw : input)
+      p.push(raw);
+    p.flush();
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+}
+
+// One indirect call per batch for the whole pipeline
+template <std::size_t BatchSize>
+static void fused(benchmark::State& state) {
+  auto const input = make_input(state.range(0));
+  long sum = 0;
+  auto p = make_pipeline<std::uint32_t, BatchSize>()
+             .then(map(parse) | filter(keep) | map(transform))
+             .sink([&sum](int x) { sum += x; });
+
+  for (auto _ : state) {
+    for (auto raw : input)
+      p.push(raw);
+    p.flush();
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+}
+
+BENCHMARK(per_element)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(batched, 16)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(batched, 256)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(fused, 16)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(fused, 256)->Arg(1 << 16);
+
+BENCHMARK_MAIN();
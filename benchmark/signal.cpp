@@ -0,0 +1,119 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// Emitting a signal to many subscribers from several threads, and connecting
+// and disconnecting a subscriber, with the signal of signal.hpp and with the
+// usual vector of std::function protected by a mutex.
+
+#include "signal.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+
+class locked_signal {
+  std::mutex mutex_;
+  std::vector<std::pair<std::size_t, std::function<void(int)>>> slots_;
+  std::size_t next_id_ = 0;
+
+public:
+  template <typename F>
+  std::size_t connect(F f) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    slots_.emplace_back(next_id_, std::move(f));
+    return next_id_++;
+  }
+
+  void disconnect(std::size_t id) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    slots_.erase(std::find_if(slots_.begin(), slots_.end(),
+                              [=](auto const& s) { return s.first == id; }));
+  }
+
+  void operator()(int x) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    for (auto const& s : slots_)
+      s.second(x);
+  }
+};
+
+// Each subscriber adds to its own counter, so subscribers don't contend with
+// each other beyond what the signal itself does.
+struct subscribers {
+  std::unique_ptr<std::atomic<long>[]> counters;
+  explicit subscribers(std::size_t n) : counters{new std::atomic<long>[n]()} { }
+};
+
+std::unique_ptr<subscribers> counters;
+std::unique_ptr<locked_signal> locked;
+std::unique_ptr<signal<void(int)>> lock_free;
+
+static void setup(benchmark::State const& state) {
+  std::size_t const n = state.range(0);
+  counters = std::make_unique<subscribers>(n);
+  locked = std::make_unique<locked_signal>();
+  lock_free = std::make_unique<signal<void(int)>>();
+  for (std::size_t i = 0; i != n; ++i) {
+    std::atomic<long>* counter = &counters->counters[i];
+    locked->connect([counter](int x) { counter->fetch_add(x, std::memory_order_relaxed); });
+    lock_free->connect([counter](int x) { counter->fetch_add(x, std::memory_order_relaxed); });
+  }
+}
+
+static void teardown(benchmark::State const&) {
+  lock_free.reset();
+  locked.reset();
+  counters.reset();
+}
+
+static void emit_locked(benchmark::State& state) {
+  for (auto _ : state)
+    (*locked)(1);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void emit_lock_free(benchmark::State& state) {
+  for (auto _ : state)
+    (*lock_free)(1);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(emit_locked)->Setup(setup)->Teardown(teardown)
+  ->Arg(1)->Arg(1000)->Arg(10000)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(emit_lock_free)->Setup(setup)->Teardown(teardown)
+  ->Arg(1)->Arg(1000)->Arg(10000)->ThreadRange(1, 8)->UseRealTime();
+
+
+// Connecting and immediately disconnecting a subscriber, next to the
+// existing ones. The lock-free signal waits for in-flight emissions before
+// destroying the slot, so this is mostly the cost of that wait.
+static void connect_disconnect_locked(benchmark::State& state) {
+  for (auto _ : state) {
+    std::size_t id = locked->connect([](int x) { benchmark::DoNotOptimize(x); });
+    locked->disconnect(id);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void connect_disconnect_lock_free(benchmark::State& state) {
+  for (auto _ : state) {
+    auto c = lock_free->connect([](int x) { benchmark::DoNotOptimize(x); });
+    c.disconnect();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(connect_disconnect_locked)->Setup(setup)->Teardown(teardown)
+  ->Arg(1)->Arg(1000)->Arg(10000);
+BENCHMARK(connect_disconnect_lock_free)->Setup(setup)->Teardown(teardown)
+  ->Arg(1)->Arg(1000)->Arg(10000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,95 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#include "sort_by_key.hpp"
+#include "sort_by_key_vehicle.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+using sort_by_key_vehicle::Vehicle;
+
+
+struct Car   { std::string make; int year; void accelerate() { } };
+struct Truck { std::string make; int year; void accelerate() { } };
+struct Plane { std::string make; int year; void accelerate() { } };
+
+static std::vector<Vehicle> make_fleet(std::size_t n) {
+  std::mt19937 gen{42};
+  std::uniform_int_distribution<int> year{1900, 2018};
+  std::vector<Vehicle> fleet;
+  fleet.reserve(n);
+  for (std::size_t i = 0; i != n; ++i) {
+    switch (i % 3) {
+      case 0: fleet.push_back(Car{"", year(gen)}); break;
+      case 1: fleet.push_back(Truck{"", year(gen)}); break;
+      case 2: fleet.push_back(Plane{"", year(gen)}); break;
+    }
+  }
+  std::shuffle(fleet.begin(), fleet.end(), gen);
+  return fleet;
+}
+
+// Two indirect calls per comparison, O(n log n) comparisons.
+static void std_sort_through_vtable(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto fleet = make_fleet(state.range(0));
+    state.ResumeTiming();
+
+    std::sort(fleet.begin(), fleet.end(), [](Vehicle const& a, Vehicle const& b) {
+      return a.year() < b.year();
+    });
+    benchmark::DoNotOptimize(fleet.data());
+
+    state.PauseTiming();
+    fleet.clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void std_stable_sort_through_vtable(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto fleet = make_fleet(state.range(0));
+    state.ResumeTiming();
+
+    std::stable_sort(fleet.begin(), fleet.end(), [](Vehicle const& a, Vehicle const& b) {
+      return a.year() < b.year();
+    });
+    benchmark::DoNotOptimize(fleet.data());
+
+    state.PauseTiming();
+    fleet.clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// One indirect call per element.
+static void sort_by_key(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto fleet = make_fleet(state.range(0));
+    state.ResumeTiming();
+
+    sort_by_key(fleet, &Vehicle::year);
+    benchmark::DoNotOptimize(fleet.data());
+
+    state.PauseTiming();
+    fleet.clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(std_sort_through_vtable)->Range(1 << 10, 1 << 20);
+BENCHMARK(std_stable_sort_through_vtable)->Range(1 << 10, 1 << 20);
+BENCHMARK(sort_by_key)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_MAIN();
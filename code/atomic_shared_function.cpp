@@ -0,0 +1,72 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#include "atomic_shared_function.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <deque>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+// A handler that detects being called after it was destroyed. Its flag is
+// kept in a registry that outlives it, so that such a call can still read it.
+std::deque<std::atomic<bool>> alive_flags;
+
+struct Handler {
+  explicit Handler(int id) : id_{id}, alive_{&alive_flags.emplace_back(true)} { }
+  Handler(Handler&& other) : id_{other.id_}, alive_{std::exchange(other.alive_, nullptr)} { }
+  ~Handler() { if (alive_) *alive_ = false; }
+
+  int operator()(int request) const {
+    assert(alive_ && *alive_);
+    return request + id_;
+  }
+
+  int id_;
+  std::atomic<bool>* alive_;
+};
+
+int main() {
+  // basic use
+  {
+    atomic_shared_function<std::string(int)> f{[](int i) { return std::to_string(i); }};
+    assert(f(1) == "1");
+    f.store([](int i) { return std::to_string(i * 2); });
+    assert(f(1) == "2");
+  }
+
+  // nested calls through different functions
+  {
+    atomic_shared_function<int(int)> inner{[](int i) { return i + 1; }};
+    atomic_shared_function<int(int)> outer{[&](int i) { return inner(i) * 10; }};
+    assert(outer(1) == 20);
+  }
+
+  // many readers, one writer reconfiguring the handler
+  {
+    atomic_shared_function<int(int)> handler{Handler{0}};
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t != 4; ++t) {
+      readers.emplace_back([&] {
+        while (!done.load()) {
+          int result = handler(1000);
+          assert(result >= 1000 && result <= 1000 + 200);
+        }
+      });
+    }
+
+    for (int id = 1; id <= 200; ++id)
+      handler.store(Handler{id});
+    assert(handler(0) == 200);
+
+    done = true;
+    for (auto& reader : readers)
+      reader.join();
+  }
+}
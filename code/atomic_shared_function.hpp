@@ -0,0 +1,179 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#ifndef ATOMIC_SHARED_FUNCTION_HPP
+#define ATOMIC_SHARED_FUNCTION_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+
+namespace detail {
+  // Epoch-based protection of read-side critical sections, in the spirit of
+  // RCU. Each reader thread owns a slot where it announces the epoch it
+  // entered in, or 0 when it is not reading. A writer that unpublished an
+  // object bumps the global epoch and waits until no slot holds an older
+  // epoch; after that, no reader can still be looking at the object.
+  //
+  // Entering and leaving only write to the calling thread's own slot, which
+  // sits on its own cache line, so readers never contend with each other.
+  class epoch_domain {
+    struct alignas(64) reader {
+      std::atomic<std::uint64_t> epoch{0};
+      std::atomic<bool> in_use{true};
+      reader* next = nullptr;
+    };
+
+    struct thread_state {
+      reader* slot = nullptr;
+      unsigned depth = 0;
+      ~thread_state() { if (slot) slot->in_use.store(false, std::memory_order_release); }
+    };
+
+    std::atomic<std::uint64_t> epoch_{1};
+    std::atomic<reader*> readers_{nullptr};
+
+    reader* register_reader() {
+      for (reader* r = readers_.load(std::memory_order_acquire); r; r = r->next) {
+        bool free = false;
+        if (r->in_use.compare_exchange_strong(free, true, std::memory_order_acquire))
+          return r;
+      }
+      reader* r = new reader;
+      r->next = readers_.load(std::memory_order_relaxed);
+      while (!readers_.compare_exchange_weak(r->next, r, std::memory_order_release))
+        ;
+      return r;
+    }
+
+    static thread_state& local() { thread_local thread_state state; return state; }
+
+  public:
+    static epoch_domain& instance() { static epoch_domain domain; return domain; }
+
+    ~epoch_domain() {
+      reader* r = readers_.load();
+      while (r) {
+        reader* next = r->next;
+        delete r;
+        r = next;
+      }
+    }
+
+    void enter() {
+      thread_state& state = local();
+      if (state.depth++ != 0)
+        return;
+      if (!state.slot)
+        state.slot = register_reader();
+      state.slot->epoch.store(epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+    }
+
+    void exit() {
+      thread_state& state = local();
+      if (--state.depth == 0)
+        state.slot->epoch.store(0, std::memory_order_release);
+    }
+
+    // Whether the calling thread is inside a read-side critical section, in
+    // which case it must not call synchronize().
+    bool reading() const {
+      return local().depth != 0;
+    }
+
+    // Returns once every read-side critical section that was active when it
+    // was called has ended.
+    void synchronize() {
+      std::uint64_t const now = epoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+      for (reader* r = readers_.load(std::memory_order_acquire); r; r = r->next) {
+        std::uint64_t e;
+        while ((e = r->epoch.load(std::memory_order_seq_cst)) != 0 && e < now)
+          std::this_thread::yield();
+      }
+    }
+  };
+
+  struct read_guard {
+    read_guard() { epoch_domain::instance().enter(); }
+    ~read_guard() { epoch_domain::instance().exit(); }
+    read_guard(read_guard const&) = delete;
+    read_guard& operator=(read_guard const&) = delete;
+  };
+}
+
+template <typename Signature>
+class atomic_shared_function;
+
+// A function whose target can be replaced while other threads are calling it.
+//
+// Calling it does not take a lock and does not touch a reference count; the
+// call goes through a snapshot of the current target, protected by an epoch.
+// Replacing the target with `store` publishes the new one atomically, waits
+// for the calls that might still be using the old one to return, and then
+// destroys it. Writers are serialized with each other.
+//
+// `store` waits for readers, so it must not be called from within a call to
+// any atomic_shared_function, or it would wait for itself.
+// sample(atomic_shared_function)
+template <typename R, typename ...Args>
+class atomic_shared_function<R(Args...)> {
+  struct node {
+    R (*call)(node const* this_, Args ...args);
+    void (*delete_)(node* this_);
+  };
+
+  template <typename F>
+  struct model : node {
+    explicit model(F f)
+      : node{
+          [](node const* this_, Args ...args) -> R {
+            return static_cast<model const*>(this_)->f_(std::forward<Args>(args)...);
+          },
+          [](node* this_) {
+            delete static_cast<model*>(this_);
+          }
+        }
+      , f_(std::move(f))
+    { }
+    F f_;
+  };
+
+  std::atomic<node*> current_;
+  std::mutex writer_;
+
+public:
+  template <typename F>
+  explicit atomic_shared_function(F f)
+    : current_{new model<F>(std::move(f))}
+  { }
+
+  atomic_shared_function(atomic_shared_function const&) = delete;
+  atomic_shared_function& operator=(atomic_shared_function const&) = delete;
+
+  R operator()(Args ...args) const {
+    detail::read_guard guard;
+    node const* target = current_.load(std::memory_order_seq_cst);
+    return target->call(target, std::forward<Args>(args)...);
+  }
+
+  template <typename F>
+  void store(F f) {
+    node* replacement = new model<F>(std::move(f));
+    std::lock_guard<std::mutex> lock{writer_};
+    node* old = current_.exchange(replacement, std::memory_order_seq_cst);
+    detail::epoch_domain::instance().synchronize();
+    old->delete_(old);
+  }
+
+  // No call may be in progress when the function itself is destroyed.
+  ~atomic_shared_function() {
+    node* target = current_.load();
+    target->delete_(target);
+  }
+};
+// end-sample
+
+#endif // header guard
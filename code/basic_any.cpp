@@ -0,0 +1,103 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#include "basic_any.hpp"
+
+#include <dyno.hpp>
+
+#include <any>
+#include <array>
+#include <cassert>
+#include <string>
+#include <utility>
+
+
+//
+// Tests
+//
+
+struct Big {
+  std::array<int, 6> values;
+};
+
+template <typename Any>
+void test() {
+  // an empty any holds nothing
+  {
+    Any a;
+    assert(!a.has_value());
+    assert(any_cast<int>(&a) == nullptr);
+  }
+
+  // store values of different sizes, and get them back
+  {
+    Any i = 42;
+    Any s = std::string{"hello"};
+    Any b = Big{{1, 2, 3, 4, 5, 6}};
+    assert(i.has_value() && s.has_value() && b.has_value());
+
+    assert(i.template is<int>() && !i.template is<long>());
+    assert(*any_cast<int>(&i) == 42);
+    assert(any_cast<std::string>(s) == "hello");
+    assert(any_cast<Big>(b).values[5] == 6);
+
+    assert(any_cast<std::string>(&i) == nullptr);
+    assert(any_cast<int>(&s) == nullptr);
+    Any const& ci = i;
+    assert(*any_cast<int>(&ci) == 42);
+  }
+
+  // a failed cast by value throws like std::any_cast
+  {
+    Any a = 1;
+    bool thrown = false;
+    try {
+      any_cast<double>(a);
+    } catch (std::bad_any_cast const&) {
+      thrown = true;
+    }
+    assert(thrown);
+  }
+
+  // copies and assignments carry the type along
+  {
+    Any a = std::string{"abc"};
+    Any b = a;
+    assert(any_cast<std::string>(b) == "abc");
+
+    Any c;
+    c = b;
+    assert(any_cast<std::string>(c) == "abc");
+    c = 3.5;
+    assert(any_cast<double>(c) == 3.5);
+    assert(any_cast<std::string>(&c) == nullptr);
+
+    Any d = std::move(c);
+    assert(any_cast<double>(d) == 3.5);
+  }
+}
+
+// The type is told by the vtable, so nothing is stored next to the poly
+static_assert(sizeof(any) == sizeof(dyno::poly<IAny, dyno::sbo_storage<16>>));
+static_assert(sizeof(shared_any) == sizeof(dyno::poly<IAny, dyno::shared_remote_storage>));
+
+int main() {
+  test<any>();
+  test<inplace_any<32>>();
+  test<shared_any>();
+
+  // Copies of an sbo or local any hold their own value
+  {
+    any a = 1;
+    any b = a;
+    *any_cast<int>(&b) = 2;
+    assert(any_cast<int>(a) == 1);
+  }
+
+  // Copies of a shared_any hold the same value
+  {
+    shared_any a = std::string{"shared"};
+    shared_any b = a;
+    assert(any_cast<std::string>(&a) == any_cast<std::string>(&b));
+  }
+}
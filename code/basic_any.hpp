@@ -0,0 +1,124 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#ifndef BASIC_ANY_HPP
+#define BASIC_ANY_HPP
+
+#include <dyno.hpp>
+
+#include <any>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+
+namespace detail {
+  // One object per type, whose address identifies that type
+  template <typename T>
+  inline constexpr char any_type_id = 0;
+
+  // What a default-constructed basic_any holds
+  struct any_empty { };
+
+  // The name of IAny's method. The literals are only brought in here, so
+  // that including this header doesn't make `_s` visible everywhere.
+  namespace any_names {
+    using namespace dyno::literals;
+    using type_id = decltype("type_id"_s);
+  }
+}
+
+// Anything that can be copied, moved and destroyed, and tells its type.
+struct IAny : decltype(dyno::requires(
+  dyno::CopyConstructible{},
+  dyno::MoveConstructible{},
+  dyno::Destructible{},
+  detail::any_names::type_id{} = dyno::function<void const* (dyno::T const&)>
+)) { };
+
+template <typename T>
+auto const dyno::default_concept_map<IAny, T> = dyno::make_concept_map(
+  detail::any_names::type_id{} = [](T const&) -> void const* {
+    return &detail::any_type_id<T>;
+  }
+);
+
+// sample(basic_any)
+// A value of any copyable type, like std::any, whose storage is picked by a
+// Dyno storage policy.
+//
+// The type of the value is told by the vtable, as a pointer identifying it.
+// Checking the type in any_cast is then a single call and pointer
+// comparison, without any typeid, and the object is no larger than the poly.
+template <typename StoragePolicy>
+class basic_any {
+  dyno::poly<IAny, StoragePolicy> poly_;
+
+  template <typename T, typename S>
+  friend T const* any_cast(basic_any<S> const* a) noexcept;
+
+  void const* type_id() const
+  { return poly_.virtual_(detail::any_names::type_id{})(poly_); }
+
+public:
+  basic_any()
+    : poly_{detail::any_empty{}}
+  { }
+
+  template <typename T, typename RawT = std::decay_t<T>,
+            typename = std::enable_if_t<!std::is_same<RawT, basic_any>::value>>
+  basic_any(T&& value)
+    : poly_{std::forward<T>(value)}
+  { }
+
+  bool has_value() const
+  { return type_id() != &detail::any_type_id<detail::any_empty>; }
+
+  template <typename T>
+  bool is() const
+  { return type_id() == &detail::any_type_id<T>; }
+};
+// end-sample
+
+// sample(any_cast)
+// Returns a pointer to the value held by `a` if it is a T, and nullptr
+// otherwise, like std::any_cast.
+template <typename T, typename StoragePolicy>
+T const* any_cast(basic_any<StoragePolicy> const* a) noexcept {
+  if (a == nullptr || !a->template is<T>())
+    return nullptr;
+  return static_cast<T const*>(a->poly_.unsafe_get());
+}
+// end-sample
+
+template <typename T, typename StoragePolicy>
+T* any_cast(basic_any<StoragePolicy>* a) noexcept {
+  return const_cast<T*>(any_cast<T>(static_cast<basic_any<StoragePolicy> const*>(a)));
+}
+
+// Returns a copy of the T held by `a`, and throws std::bad_any_cast when `a`
+// does not hold a T, like std::any_cast.
+template <typename T, typename StoragePolicy>
+T any_cast(basic_any<StoragePolicy> const& a) {
+  using U = std::remove_cv_t<std::remove_reference_t<T>>;
+  if (U const* p = any_cast<U>(&a))
+    return static_cast<T>(*p);
+  throw std::bad_any_cast{};
+}
+
+// sample(any)
+using any = basic_any<dyno::sbo_storage<16>>;
+// end-sample
+
+// sample(inplace_any)
+template <std::size_t Size = 32>
+using inplace_any = basic_any<dyno::local_storage<Size>>;
+// end-sample
+
+// sample(shared_any)
+// Copies share the same value, so it must not be modified through any_cast
+// once copies exist.
+using shared_any = basic_any<dyno::shared_remote_storage>;
+// end-sample
+
+#endif // header guard
@@ -0,0 +1,62 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#include "bulk_destroy.hpp"
+#include "sbo_storage.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+using Vehicle = sbo_storage::Vehicle<16>;
+
+
+//////////////////////////////////////////////////////////////////////////////
+int destroyed = 0;
+
+struct Car {
+  std::string make;
+  int year;
+  void accelerate() { std::cout << "Car::accelerate()" << std::endl; }
+  ~Car() { ++destroyed; }
+};
+
+struct Truck {
+  std::string make;
+  int year;
+  void accelerate() { std::cout << "Truck::accelerate()" << std::endl; }
+  ~Truck() { ++destroyed; }
+};
+
+// Stored inline, and trivially destructible
+struct Bike {
+  int year;
+  void accelerate() { std::cout << "Bike::accelerate()" << std::endl; }
+};
+
+// Stored inline, but not trivially destructible
+struct Scooter {
+  int year;
+  void accelerate() { std::cout << "Scooter::accelerate()" << std::endl; }
+  ~Scooter() { ++destroyed; }
+};
+
+int main() {
+  std::vector<Vehicle> vehicles;
+  for (int i = 0; i != 100; ++i) {
+    vehicles.push_back(Car{"Audi", 2017});
+    vehicles.push_back(Truck{"Chevrolet", 2015});
+    vehicles.push_back(Bike{2018});
+    vehicles.push_back(Scooter{2016});
+  }
+  vehicles[0].accelerate();
+  vehicles[2].accelerate();
+
+  destroyed = 0;
+  clear(vehicles);
+  assert(vehicles.empty());
+  assert(destroyed == 300);
+}
@@ -0,0 +1,363 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <new>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+//////////////////////////////////////////////////////////////////////////////
+// Coroutine frames are allocated through this hook instead of the global
+// operator new. Freed frames are kept on per-thread free lists bucketed by
+// size, so a coroutine that is started over and over reuses the same frame
+// and steady-state `co_await`s don't allocate.
+//////////////////////////////////////////////////////////////////////////////
+class frame_allocator {
+  static constexpr std::size_t granularity = 64;
+  static constexpr std::size_t classes = 16;
+
+  struct node { node* next; };
+  struct state {
+    node* free[classes] = {};
+    std::size_t heap_allocations = 0;
+    ~state() {
+      for (node* head : free) {
+        while (head) {
+          node* next = head->next;
+          ::operator delete(head);
+          head = next;
+        }
+      }
+    }
+  };
+  static state& local() { thread_local state s; return s; }
+
+  static std::size_t size_class(std::size_t n)
+  { return (n + granularity - 1) / granularity; }
+
+public:
+  static void* allocate(std::size_t n) {
+    state& s = local();
+    std::size_t c = size_class(n);
+    if (c < classes && s.free[c]) {
+      node* p = s.free[c];
+      s.free[c] = p->next;
+      return p;
+    }
+    ++s.heap_allocations;
+    return ::operator new(c < classes ? c * granularity : n);
+  }
+
+  static void deallocate(void* p, std::size_t n) {
+    state& s = local();
+    std::size_t c = size_class(n);
+    if (c >= classes)
+      return ::operator delete(p);
+    s.free[c] = new (p) node{s.free[c]};
+  }
+
+  // Number of frames that could not be served from a free list.
+  static std::size_t heap_allocations() { return local().heap_allocations; }
+};
+
+
+//////////////////////////////////////////////////////////////////////////////
+// A lazily-started coroutine returning `R`. Awaiting a task starts it, and
+// the awaiting coroutine is resumed when the task completes.
+//////////////////////////////////////////////////////////////////////////////
+template <typename R>
+struct task;
+
+namespace detail {
+  template <typename R>
+  struct task_result {
+    std::optional<R> value_;
+    template <typename T>
+    void return_value(T&& value) { value_.emplace(std::forward<T>(value)); }
+    R result() { return std::move(*value_); }
+  };
+
+  template <>
+  struct task_result<void> {
+    void return_void() { }
+    void result() { }
+  };
+}
+
+template <typename R>
+struct task {
+  struct promise_type : detail::task_result<R> {
+    std::coroutine_handle<> continuation_ = std::noop_coroutine();
+
+    static void* operator new(std::size_t n) { return frame_allocator::allocate(n); }
+    static void operator delete(void* p, std::size_t n) { frame_allocator::deallocate(p, n); }
+
+    task get_return_object()
+    { return task{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    auto final_suspend() noexcept {
+      struct awaiter : std::suspend_always {
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> self) noexcept
+        { return self.promise().continuation_; }
+      };
+      return awaiter{};
+    }
+
+    void unhandled_exception() { std::terminate(); }
+  };
+
+  explicit task(std::coroutine_handle<promise_type> h) : handle_{h} { }
+  task(task&& other) noexcept : handle_{std::exchange(other.handle_, nullptr)} { }
+  task& operator=(task&&) = delete;
+  ~task() { if (handle_) handle_.destroy(); }
+
+  bool await_ready() const noexcept { return false; }
+
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+    handle_.promise().continuation_ = awaiting;
+    return handle_;
+  }
+
+  R await_resume() { return handle_.promise().result(); }
+
+  bool done() const { return handle_.done(); }
+  void start() { handle_.resume(); }
+
+private:
+  std::coroutine_handle<promise_type> handle_;
+};
+
+
+//////////////////////////////////////////////////////////////////////////////
+// A type-erased awaitable kept in a local buffer, like `local_storage`. The
+// three `await_*` functions go through a vtable; the result of the erased
+// `await_suspend` is normalized to a `coroutine_handle<>`.
+//////////////////////////////////////////////////////////////////////////////
+// sample(awaitable_vtable)
+template <typename R>
+struct awaitable_vtable {
+  bool (*await_ready)(void* this_);
+  std::coroutine_handle<> (*await_suspend)(void* this_, std::coroutine_handle<>);
+  R (*await_resume)(void* this_);
+  void (*move)(void* p, void* other);
+  void (*dtor)(void* this_);
+};
+// end-sample
+
+template <typename R, typename A>
+inline constexpr awaitable_vtable<R> awaitable_vtable_for = {
+  [](void* this_) -> bool {
+    return static_cast<A*>(this_)->await_ready();
+  },
+
+  [](void* this_, std::coroutine_handle<> h) -> std::coroutine_handle<> {
+    using Result = decltype(static_cast<A*>(this_)->await_suspend(h));
+    if constexpr (std::is_void_v<Result>) {
+      static_cast<A*>(this_)->await_suspend(h);
+      return std::noop_coroutine();
+    } else if constexpr (std::is_same_v<Result, bool>) {
+      return static_cast<A*>(this_)->await_suspend(h) ? std::noop_coroutine() : h;
+    } else {
+      return static_cast<A*>(this_)->await_suspend(h);
+    }
+  },
+
+  [](void* this_) -> R {
+    return static_cast<A*>(this_)->await_resume();
+  },
+
+  [](void* p, void* other) {
+    new (p) A(std::move(*static_cast<A*>(other)));
+  },
+
+  [](void* this_) {
+    static_cast<A*>(this_)->~A();
+  }
+};
+
+// sample(any_awaitable)
+template <typename R, std::size_t Size = 32>
+class any_awaitable {
+  awaitable_vtable<R> const* vptr_;
+  std::aligned_storage_t<Size> buffer_;
+
+public:
+  template <typename Awaitable>
+  any_awaitable(Awaitable awaitable)
+    : vptr_{&awaitable_vtable_for<R, Awaitable>}
+  {
+    static_assert(sizeof(Awaitable) <= Size,
+      "can't hold such a large awaitable in an any_awaitable");
+    new (&buffer_) Awaitable(std::move(awaitable));
+  }
+                                                          // skip-sample
+  any_awaitable(any_awaitable&& other) : vptr_{other.vptr_} { // skip-sample
+    vptr_->move(&buffer_, &other.buffer_);                // skip-sample
+  }                                                       // skip-sample
+
+  bool await_ready()
+  { return vptr_->await_ready(&buffer_); }
+
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> h)
+  { return vptr_->await_suspend(&buffer_, h); }
+
+  R await_resume()
+  { return vptr_->await_resume(&buffer_); }
+
+  ~any_awaitable()
+  { vptr_->dtor(&buffer_); }
+};
+// end-sample
+
+
+//////////////////////////////////////////////////////////////////////////////
+// The usual vtable, with an asynchronous method added.
+//////////////////////////////////////////////////////////////////////////////
+// sample(vtable)
+struct vtable {
+  void (*accelerate)(void* this_);
+  any_awaitable<void> (*accelerate_async)(void* this_);
+  void (*copy)(void* p, void const* other); // skip-sample
+  void (*dtor)(void* this_);
+};
+
+template <typename T>
+inline constexpr vtable vtable_for = {
+  [](void* this_) {
+    static_cast<T*>(this_)->accelerate();
+  },
+
+  [](void* this_) -> any_awaitable<void> {
+    return static_cast<T*>(this_)->accelerate_async();
+  },
+                                                  // skip-sample
+  [](void* p, void const* other) {                // skip-sample
+    new (p) T(*static_cast<T const*>(other));     // skip-sample
+  },                                              // skip-sample
+
+  [](void* this_) {
+    static_cast<T*>(this_)->~T();
+  }
+};
+// end-sample
+
+// sample(Vehicle)
+class Vehicle {
+  vtable const* const vptr_;
+  std::aligned_storage_t<64> buffer_;
+
+public:
+  template <typename Any>
+  Vehicle(Any vehicle) : vptr_{&vtable_for<Any>} {
+    static_assert(sizeof(Any) <= sizeof(buffer_),
+      "can't hold such a large object in a Vehicle");
+    new (&buffer_) Any(vehicle);
+  }
+                                                        // skip-sample
+  Vehicle(Vehicle const& other) : vptr_{other.vptr_} {  // skip-sample
+    other.vptr_->copy(&buffer_, &other.buffer_);        // skip-sample
+  }                                                     // skip-sample
+
+  void accelerate()
+  { vptr_->accelerate(&buffer_); }
+
+  any_awaitable<void> accelerate_async()
+  { return vptr_->accelerate_async(&buffer_); }
+
+  ~Vehicle()
+  { vptr_->dtor(&buffer_); }
+};
+// end-sample
+
+
+//////////////////////////////////////////////////////////////////////////////
+// A trivial single-threaded scheduler standing in for an I/O event loop.
+struct scheduler {
+  std::deque<std::coroutine_handle<>> ready;
+
+  auto yield() {
+    struct awaiter : std::suspend_always {
+      scheduler* self;
+      void await_suspend(std::coroutine_handle<> h) { self->ready.push_back(h); }
+    };
+    return awaiter{{}, this};
+  }
+
+  void run() {
+    while (!ready.empty()) {
+      auto h = ready.front();
+      ready.pop_front();
+      h.resume();
+    }
+  }
+} loop;
+
+struct Car {
+  std::string make;
+  int year;
+  int speed = 0;
+  void accelerate() { ++speed; }
+  task<void> accelerate_async() { co_await loop.yield(); accelerate(); }
+};
+
+struct Truck {
+  std::string make;
+  int year;
+  int speed = 0;
+  void accelerate() { ++speed; }
+  task<void> accelerate_async() { co_await loop.yield(); accelerate(); }
+};
+
+// Not every implementation needs to be a coroutine
+struct Plane {
+  std::string make;
+  std::string model;
+  static inline int accelerations = 0;
+  void accelerate() { ++accelerations; }
+  std::suspend_never accelerate_async() { accelerate(); return {}; }
+};
+
+task<int> accelerate_all(std::vector<Vehicle>& vehicles) {
+  int n = 0;
+  for (auto& vehicle : vehicles) {
+    co_await vehicle.accelerate_async();
+    ++n;
+  }
+  co_return n;
+}
+
+int main() {
+  std::vector<Vehicle> vehicles;
+  vehicles.push_back(Car{"Audi", 2017});
+  vehicles.push_back(Truck{"Chevrolet", 2015});
+  vehicles.push_back(Plane{"Boeing", "747"});
+
+  auto round = [&] {
+    auto t = accelerate_all(vehicles);
+    t.start();
+    loop.run();
+    assert(t.done());
+    return t.await_resume();
+  };
+
+  assert(round() == 3);
+  assert(Plane::accelerations == 1);
+
+  // Once the first round warmed up the free lists, awaiting polymorphic
+  // operations does not allocate anymore.
+  std::size_t const warm = frame_allocator::heap_allocations();
+  for (int i = 0; i != 100; ++i)
+    assert(round() == 3);
+  assert(frame_allocator::heap_allocations() == warm);
+  assert(Plane::accelerations == 101);
+}
@@ -0,0 +1,189 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#include "flat_index.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+
+// sample(vtable)
+struct vtable {
+  void (*accelerate)(void* this_);
+  std::string const& (*make)(void const* this_);
+  void (*copy)(void* p, void const* other); // skip-sample
+  void (*move)(void* p, void* other);       // skip-sample
+  void (*dtor)(void* this_);
+};
+
+template <typename T>
+inline constexpr vtable vtable_for = {
+  [](void* this_) {
+    static_cast<T*>(this_)->accelerate();
+  },
+
+  [](void const* this_) -> std::string const& {
+    return static_cast<T const*>(this_)->make;
+  },
+                                                  // skip-sample
+  [](void* p, void const* other) {                // skip-sample
+    new (p) T(*static_cast<T const*>(other));     // skip-sample
+  },                                              // skip-sample
+                                                  // skip-sample
+  [](void* p, void* other) {                      // skip-sample
+    new (p) T(std::move(*static_cast<T*>(other)));// skip-sample
+  },                                              // skip-sample
+
+  [](void* this_) {
+    static_cast<T*>(this_)->~T();
+  }
+};
+// end-sample
+
+class Vehicle {
+  vtable const* const vptr_;
+  std::aligned_storage_t<64> buffer_;
+
+public:
+  template <typename Any>
+  Vehicle(Any vehicle) : vptr_{&vtable_for<Any>} {
+    static_assert(sizeof(Any) <= sizeof(buffer_),
+      "can't hold such a large object in a Vehicle");
+    new (&buffer_) Any(std::move(vehicle));
+  }
+
+  Vehicle(Vehicle const& other) : vptr_{other.vptr_} {
+    other.vptr_->copy(&buffer_, &other.buffer_);
+  }
+
+  Vehicle(Vehicle&& other) : vptr_{other.vptr_} {
+    other.vptr_->move(&buffer_, &other.buffer_);
+  }
+
+  void accelerate()
+  { vptr_->accelerate(&buffer_); }
+
+  std::string const& make() const
+  { return vptr_->make(&buffer_); }
+
+  ~Vehicle()
+  { vptr_->dtor(&buffer_); }
+};
+
+// sample(index)
+struct by_make {
+  std::string const& operator()(Vehicle const& v) const
+  { return v.make(); }
+};
+
+using VehicleIndex = flat_index<Vehicle, by_make>;
+// end-sample
+
+
+// Counts how many times a key is asked for
+struct counting_by_make {
+  static inline int calls = 0;
+  std::string const& operator()(Vehicle const& v) const
+  { ++calls; return v.make(); }
+};
+
+
+//////////////////////////////////////////////////////////////////////////////
+struct Car {
+  std::string make;
+  int year;
+  int speed = 0;
+  void accelerate() { ++speed; }
+};
+
+struct Truck {
+  std::string make;
+  int year;
+  int speed = 0;
+  void accelerate() { ++speed; }
+};
+
+struct Plane {
+  std::string make;
+  std::string model;
+  void accelerate() { }
+};
+
+int main() {
+  VehicleIndex vehicles;
+
+  bool inserted = vehicles.insert(Car{"Audi", 2017});
+  inserted = vehicles.insert(Truck{"Chevrolet", 2015}) && inserted;
+  inserted = vehicles.insert(Plane{"Boeing", "747"}) && inserted;
+  assert(inserted);
+  bool duplicate = vehicles.insert(Car{"Audi", 2018});
+  assert(!duplicate);
+  assert(vehicles.size() == 3);
+
+  assert(vehicles.find("Audi") != nullptr);
+  assert(vehicles.find("Audi")->make() == "Audi");
+  assert(vehicles.find("Boeing")->make() == "Boeing");
+  assert(vehicles.find("Tesla") == nullptr);
+  vehicles.find("Chevrolet")->accelerate();
+
+  // growing and erasing keep every element reachable
+  int count_inserted = 0;
+  for (int i = 0; i != 1000; ++i)
+    count_inserted += vehicles.insert(Car{"Car #" + std::to_string(i), 2000 + i % 18});
+  assert(count_inserted == 1000);
+  assert(vehicles.size() == 1003);
+
+  int count_erased = 0;
+  for (int i = 0; i != 1000; i += 2)
+    count_erased += vehicles.erase("Car #" + std::to_string(i));
+  assert(count_erased == 500);
+  bool erased_twice = vehicles.erase("Car #0");
+  assert(!erased_twice);
+  assert(vehicles.size() == 503);
+
+  for (int i = 0; i != 1000; ++i) {
+    Vehicle* v = vehicles.find("Car #" + std::to_string(i));
+    assert((v != nullptr) == (i % 2 == 1));
+  }
+  assert(vehicles.find("Audi") && vehicles.find("Chevrolet") && vehicles.find("Boeing"));
+
+  std::size_t count = 0;
+  vehicles.for_each([&](Vehicle&) { ++count; });
+  assert(count == 503);
+
+  // Keys that fit in the inline prefix are only asked for on insertion;
+  // rehashing, lookups and erasure use the probe entries.
+  flat_index<Vehicle, counting_by_make> counted;
+  count_inserted = 0;
+  for (int i = 0; i != 100; ++i)
+    count_inserted += counted.insert(Car{"Car #" + std::to_string(i), 2000});
+  assert(count_inserted == 100);
+  assert(counting_by_make::calls == 100);
+  for (int i = 0; i != 100; ++i)
+    assert(counted.find("Car #" + std::to_string(i)) != nullptr);
+  assert(counted.find("Tesla") == nullptr);
+  bool erased = counted.erase("Car #42");
+  erased_twice = counted.erase("Car #42");
+  assert(erased && !erased_twice);
+  assert(counting_by_make::calls == 100);
+
+  // Longer keys are compared in full only when their hash, length and prefix
+  // all match, which for a missing key is almost never.
+  std::string const long_make = "Bayerische Motoren Werke";
+  inserted = counted.insert(Car{long_make, 2000});
+  assert(inserted);
+  assert(counting_by_make::calls == 101);
+  assert(counted.find(long_make) != nullptr);
+  assert(counting_by_make::calls == 102);
+  assert(counted.find("Bayerische Motoren Werkz") == nullptr);
+  assert(counted.find("Bayerische Motoren") == nullptr);
+  assert(counting_by_make::calls == 102);
+  erased = counted.erase(long_make);
+  assert(erased);
+  assert(counted.find(long_make) == nullptr);
+  assert(counted.size() == 99);
+}
@@ -0,0 +1,199 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#ifndef FLAT_INDEX_HPP
+#define FLAT_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+
+// An open-addressing hash table of `Vehicle` handles keyed by a string, where
+// the handles are stored directly in the table's slots. The key of a vehicle
+// is `KeyOf{}(vehicle)`, which usually dispatches through the vtable, so it
+// is computed at insertion and summarized in a dense array of probe entries
+// next to the slots: the hash of the key, its length and its first 16
+// bytes. The key of a vehicle must not change while it is in the table.
+//
+// A lookup scans the entries (two per cache line) with linear probing, and
+// compares the inline prefix once the hash and the length match. Keys that
+// fit in the prefix are compared without leaving the entry, so finding one
+// touches the cache line of its entry and the one of its slot. Only longer
+// keys are compared in full, through `KeyOf`, and only when everything else
+// matched.
+template <typename Vehicle, typename KeyOf>
+class flat_index {
+  using slot = std::aligned_storage_t<sizeof(Vehicle), alignof(Vehicle)>;
+  static constexpr std::uint64_t empty = 0;
+  static constexpr std::size_t prefix_size = 16;
+
+  struct alignas(32) entry {
+    std::uint64_t hash;
+    std::size_t size;
+    char prefix[prefix_size];
+  };
+
+  std::unique_ptr<entry[]> entries_;
+  std::unique_ptr<slot[]> slots_;
+  std::size_t mask_ = 0;
+  std::size_t size_ = 0;
+
+  static std::uint64_t hash(std::string_view key) {
+    std::uint64_t h = std::hash<std::string_view>{}(key);
+    return h == empty ? 1 : h;
+  }
+
+  Vehicle& at(std::size_t i) const
+  { return *std::launder(reinterpret_cast<Vehicle*>(&slots_[i])); }
+
+  bool matches(std::size_t i, std::uint64_t h, std::string_view key) const {
+    entry const& e = entries_[i];
+    if (e.hash != h || e.size != key.size())
+      return false;
+    if (key.size() <= prefix_size)
+      return key == std::string_view{e.prefix, key.size()};
+    return key.substr(0, prefix_size) == std::string_view{e.prefix, prefix_size}
+        && key == std::string_view{KeyOf{}(at(i))};
+  }
+
+  // Index of the slot holding `key`, or of the empty slot where it would go.
+  std::size_t probe(std::uint64_t h, std::string_view key) const {
+    std::size_t i = h & mask_;
+    while (entries_[i].hash != empty) {
+      if (matches(i, h, key))
+        return i;
+      i = (i + 1) & mask_;
+    }
+    return i;
+  }
+
+  // Index of the first empty slot for a key that is known not to be there.
+  std::size_t free_slot(std::uint64_t h) const {
+    std::size_t i = h & mask_;
+    while (entries_[i].hash != empty)
+      i = (i + 1) & mask_;
+    return i;
+  }
+
+  void rehash(std::size_t capacity) {
+    flat_index bigger{capacity};
+    for (std::size_t i = 0; mask_ && i != mask_ + 1; ++i) {
+      if (entries_[i].hash != empty) {
+        std::size_t j = bigger.free_slot(entries_[i].hash);
+        new (&bigger.slots_[j]) Vehicle(std::move(at(i)));
+        bigger.entries_[j] = entries_[i];
+        ++bigger.size_;
+      }
+    }
+    swap(bigger);
+  }
+
+public:
+  flat_index() = default;
+
+  // Creates an index that can hold `capacity` elements without rehashing.
+  explicit flat_index(std::size_t capacity) {
+    std::size_t slots = 16;
+    while (slots * 3 / 4 < capacity)
+      slots *= 2;
+    entries_.reset(new entry[slots]());
+    slots_.reset(new slot[slots]);
+    mask_ = slots - 1;
+  }
+
+  flat_index(flat_index&& other)
+    : entries_{std::move(other.entries_)}
+    , slots_{std::move(other.slots_)}
+    , mask_{std::exchange(other.mask_, 0)}
+    , size_{std::exchange(other.size_, 0)}
+  { }
+
+  flat_index& operator=(flat_index other) {
+    swap(other);
+    return *this;
+  }
+
+  void swap(flat_index& other) {
+    std::swap(entries_, other.entries_);
+    std::swap(slots_, other.slots_);
+    std::swap(mask_, other.mask_);
+    std::swap(size_, other.size_);
+  }
+
+  ~flat_index() {
+    for (std::size_t i = 0; mask_ && i != mask_ + 1; ++i)
+      if (entries_[i].hash != empty)
+        at(i).~Vehicle();
+  }
+
+  std::size_t size() const { return size_; }
+
+  // Inserts `vehicle` unless a vehicle with the same key is already there.
+  // Returns whether the insertion took place.
+  bool insert(Vehicle vehicle) {
+    if ((size_ + 1) * 4 > (mask_ + 1) * 3)
+      rehash(size_ + 1 > 12 ? (size_ + 1) * 2 : 12);
+
+    std::string_view key = KeyOf{}(vehicle);
+    std::uint64_t h = hash(key);
+    std::size_t i = probe(h, key);
+    if (entries_[i].hash != empty)
+      return false;
+    // `key` may point into `vehicle`, so copy its prefix before moving from it
+    entry& e = entries_[i];
+    e.size = key.size();
+    key.copy(e.prefix, prefix_size);
+    new (&slots_[i]) Vehicle(std::move(vehicle));
+    e.hash = h;
+    ++size_;
+    return true;
+  }
+
+  Vehicle* find(std::string_view key) const {
+    if (size_ == 0)
+      return nullptr;
+    std::size_t i = probe(hash(key), key);
+    return entries_[i].hash == empty ? nullptr : &at(i);
+  }
+
+  // Removes the vehicle with the given key, if any. Following elements of the
+  // probe sequence are shifted back, so no tombstones are left behind.
+  bool erase(std::string_view key) {
+    if (size_ == 0)
+      return false;
+    std::size_t hole = probe(hash(key), key);
+    if (entries_[hole].hash == empty)
+      return false;
+    at(hole).~Vehicle();
+    entries_[hole].hash = empty;
+    --size_;
+
+    for (std::size_t i = (hole + 1) & mask_; entries_[i].hash != empty; i = (i + 1) & mask_) {
+      std::size_t home = entries_[i].hash & mask_;
+      // move i into the hole unless its home lies cyclically in (hole, i]
+      if (((i - home) & mask_) >= ((i - hole) & mask_)) {
+        new (&slots_[hole]) Vehicle(std::move(at(i)));
+        at(i).~Vehicle();
+        entries_[hole] = entries_[i];
+        entries_[i].hash = empty;
+        hole = i;
+      }
+    }
+    return true;
+  }
+
+  template <typename F>
+  void for_each(F f) const {
+    for (std::size_t i = 0; mask_ && i != mask_ + 1; ++i)
+      if (entries_[i].hash != empty)
+        f(at(i));
+  }
+};
+
+#endif // header guard
@@ -0,0 +1,110 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#include "for_each_prefetched.hpp"
+#include "vtable.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+// sample(Vehicle)
+class Vehicle {
+  vtable const* const vptr_;
+  void* ptr_;
+
+public:
+  template <typename Any>
+  Vehicle(Any vehicle)
+    : vptr_{&vtable_for<Any>}
+    , ptr_{new Any(std::move(vehicle))}
+  { }
+                                                      // skip-sample
+  Vehicle(Vehicle const& other)                       // skip-sample
+    : vptr_{other.vptr_}                              // skip-sample
+    , ptr_{other.vptr_->clone(other.ptr_)}            // skip-sample
+  { }                                                 // skip-sample
+
+  void accelerate()
+  { vptr_->accelerate(ptr_); }
+
+  void prefetch() const {
+    ::prefetch(vptr_);
+    ::prefetch(ptr_);
+  }
+
+  ~Vehicle()
+  { vptr_->delete_(ptr_); }
+};
+// end-sample
+
+class SharedVehicle {
+  vtable const* const vptr_;
+  std::shared_ptr<void> ptr_;
+
+public:
+  template <typename Any>
+  SharedVehicle(Any vehicle)
+    : vptr_{&vtable_for<Any>}
+    , ptr_{std::make_shared<Any>(std::move(vehicle))}
+  { }
+
+  void accelerate()
+  { vptr_->accelerate(ptr_.get()); }
+
+  void prefetch() const {
+    ::prefetch(vptr_);
+    ::prefetch(ptr_.get());
+  }
+};
+
+
+//////////////////////////////////////////////////////////////////////////////
+int cars = 0, trucks = 0, planes = 0;
+
+struct Car {
+  std::string make;
+  int year;
+  void accelerate() { ++cars; }
+};
+
+struct Truck {
+  std::string make;
+  int year;
+  void accelerate() { ++trucks; }
+};
+
+struct Plane {
+  std::string make;
+  std::string model;
+  void accelerate() { ++planes; }
+};
+
+template <typename Handle>
+void test() {
+  std::vector<Handle> vehicles;
+  for (int i = 0; i != 10; ++i) {
+    vehicles.push_back(Car{"Audi", 2017});
+    vehicles.push_back(Truck{"Chevrolet", 2015});
+    vehicles.push_back(Plane{"Boeing", "747"});
+  }
+
+  // every element is visited exactly once, whatever the distance
+  for (std::size_t distance : {0, 1, 4, 29, 30, 100}) {
+    cars = trucks = planes = 0;
+    for_each_prefetched(vehicles, &Handle::accelerate, distance);
+    assert(cars == 10 && trucks == 10 && planes == 10);
+  }
+
+  std::vector<Handle> none;
+  for_each_prefetched(none, &Handle::accelerate, 8);
+}
+
+int main() {
+  test<Vehicle>();
+  test<SharedVehicle>();
+}
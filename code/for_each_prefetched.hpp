@@ -0,0 +1,56 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#ifndef FOR_EACH_PREFETCHED_HPP
+#define FOR_EACH_PREFETCHED_HPP
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#  include <xmmintrin.h>
+#endif
+
+
+// Hints the processor that the cache line containing `p` is about to be read.
+inline void prefetch(void const* p) {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(p);
+#elif defined(_MSC_VER)
+  _mm_prefetch(static_cast<char const*>(p), _MM_HINT_T0);
+#else
+  (void)p;
+#endif
+}
+
+// Calls `std::invoke(method, vehicle)` on every element of `vehicles` in
+// order, while asking element i + `distance` to prefetch whatever it will
+// need to be dispatched (its vtable and, with remote storage, its payload).
+// Handles provide this through a `prefetch()` member function.
+//
+// When the payloads are scattered on the heap, this overlaps the cache misses
+// of upcoming elements with the calls on the current ones. The right distance
+// depends on the machine and on the cost of the calls, so measure it.
+template <typename Vehicle, typename Method>
+void for_each_prefetched(std::vector<Vehicle>& vehicles, Method method,
+                         std::size_t distance)
+{
+  std::size_t const size = vehicles.size();
+  std::size_t i = 0;
+
+  if (distance != 0) {
+    for (std::size_t j = 0; j != distance && j != size; ++j)
+      vehicles[j].prefetch();
+
+    for (; i + distance < size; ++i) {
+      vehicles[i + distance].prefetch();
+      std::invoke(method, vehicles[i]);
+    }
+  }
+
+  for (; i != size; ++i)
+    std::invoke(method, vehicles[i]);
+}
+
+#endif // header guard
@@ -1,6 +1,8 @@
 // Copyright Louis Dionne 2018
 // Distributed under the Boost Software License, Version 1.0.
 
+#include "functions.hpp"
+
 #include <dyno.hpp>
 
 #include <cassert>
@@ -10,66 +12,6 @@
 using namespace dyno::literals;
 
 
-template <typename Signature>
-struct Callable;
-
-template <typename R, typename ...Args>
-struct Callable<R(Args...)> : decltype(dyno::requires(
-  dyno::CopyConstructible{},
-  dyno::MoveConstructible{},
-  dyno::Destructible{},
-  "call"_s = dyno::function<R (dyno::T const&, Args...)>
-)) { };
-
-template <typename R, typename ...Args, typename F>
-auto const dyno::default_concept_map<Callable<R(Args...)>, F> = dyno::make_concept_map(
-  "call"_s = [](F const& f, Args ...args) -> R {
-    return f(std::forward<Args>(args)...);
-  }
-);
-
-// sample(basic_function)
-template <typename Signature, typename StoragePolicy>
-struct basic_function;
-
-template <typename R, typename ...Args, typename StoragePolicy>
-struct basic_function<R(Args...), StoragePolicy> {
-  template <typename F>
-  basic_function(F&& f) : poly_{std::forward<F>(f)} { }
-
-  R operator()(Args ...args) const
-  { return poly_.virtual_("call"_s)(poly_, args...); }
-
-private:
-  dyno::poly<Callable<R(Args...)>, StoragePolicy> poly_;
-};
-// end-sample
-
-// sample(function)
-template <typename Signature>
-using function = basic_function<Signature,
-                                dyno::sbo_storage<16>>;
-// end-sample
-
-// sample(function_view)
-template <typename Signature>
-using function_view = basic_function<Signature,
-                                     dyno::non_owning_storage>;
-// end-sample
-
-// sample(inplace_function)
-template <typename Signature, std::size_t Size = 32>
-using inplace_function = basic_function<Signature,
-                                        dyno::local_storage<Size>>;
-// end-sample
-
-// sample(shared_function)
-template <typename Signature>
-using shared_function = basic_function<Signature,
-                                       dyno::shared_remote_storage>;
-// end-sample
-
-
 //
 // Tests
 //
@@ -143,9 +85,15 @@ void test() {
 template <typename Signature>
 using my_inplace_function = inplace_function<Signature>;
 
+// The whole vtable stored remotely, like before the call was made inline
+template <typename Signature>
+using remote_vtable_function = basic_function<Signature,
+                                              dyno::sbo_storage<16>>;
+
 int main() {
   test<function>();
   test<function_view>();
   test<my_inplace_function>();
   test<shared_function>();
+  test<remote_vtable_function>();
 }
@@ -0,0 +1,106 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#ifndef FUNCTIONS_HPP
+#define FUNCTIONS_HPP
+
+#include <dyno.hpp>
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+
+// The `_s` literals are only brought in inside this namespace, so that
+// including this header doesn't make them visible everywhere. The names are
+// made available at global scope below.
+namespace function_wrappers {
+using namespace dyno::literals;
+
+template <typename Signature>
+struct Callable;
+
+template <typename R, typename ...Args>
+struct Callable<R(Args...)> : decltype(dyno::requires(
+  dyno::CopyConstructible{},
+  dyno::MoveConstructible{},
+  dyno::Destructible{},
+  "call"_s = dyno::function<R (dyno::T const&, Args...)>
+)) { };
+
+// The name of Callable's method, for its concept map below
+using call_name = decltype("call"_s);
+
+// sample(inline_call)
+// A callable has a single hot method, so its function pointer is stored
+// inline in the object, saving a pointer hop on every call. The rest of the
+// vtable (copy, move, destroy) stays remote.
+using inline_call = dyno::vtable<
+  dyno::local<dyno::only<decltype("call"_s)>>,
+  dyno::remote<dyno::everything_else>
+>;
+// end-sample
+
+// sample(basic_function)
+template <typename Signature, typename StoragePolicy,
+          typename VTablePolicy = dyno::vtable<dyno::remote<dyno::everything>>>
+struct basic_function;
+
+template <typename R, typename ...Args, typename StoragePolicy, typename VTablePolicy>
+struct basic_function<R(Args...), StoragePolicy, VTablePolicy> {
+  // Copies and moves of a basic_function must not wrap it in another one
+  template <typename F, typename = std::enable_if_t<
+    !std::is_same<std::decay_t<F>, basic_function>::value>>
+  basic_function(F&& f) : poly_{std::forward<F>(f)} { }
+
+  R operator()(Args ...args) const
+  { return poly_.virtual_("call"_s)(poly_, args...); }
+
+private:
+  dyno::poly<Callable<R(Args...)>, StoragePolicy, VTablePolicy> poly_;
+};
+// end-sample
+
+// sample(function)
+template <typename Signature>
+using function = basic_function<Signature,
+                                dyno::sbo_storage<16>,
+                                inline_call>;
+// end-sample
+
+// sample(function_view)
+template <typename Signature>
+using function_view = basic_function<Signature,
+                                     dyno::non_owning_storage>;
+// end-sample
+
+// sample(inplace_function)
+template <typename Signature, std::size_t Size = 32>
+using inplace_function = basic_function<Signature,
+                                        dyno::local_storage<Size>,
+                                        inline_call>;
+// end-sample
+
+// sample(shared_function)
+template <typename Signature>
+using shared_function = basic_function<Signature,
+                                       dyno::shared_remote_storage>;
+// end-sample
+} // end namespace function_wrappers
+
+using function_wrappers::Callable;
+using function_wrappers::inline_call;
+using function_wrappers::basic_function;
+using function_wrappers::function;
+using function_wrappers::function_view;
+using function_wrappers::inplace_function;
+using function_wrappers::shared_function;
+
+template <typename R, typename ...Args, typename F>
+constexpr auto dyno::default_concept_map<Callable<R(Args...)>, F> = dyno::make_concept_map(
+  function_wrappers::call_name{} = [](F const& f, Args ...args) -> R {
+    return f(std::forward<Args>(args)...);
+  }
+);
+
+#endif // header guard
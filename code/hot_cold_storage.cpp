@@ -0,0 +1,208 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// A type stored with hot/cold splitting declares its two halves: the fields
+// used all the time, kept inline in the handle, and the rest, kept in a
+// remote allocation. Its methods are static functions of those halves, and a
+// method whose signature only takes the hot half declares that it doesn't
+// need the cold one, which is then never touched when calling it. A type
+// whose cold half is empty gets no remote allocation at all.
+//
+// sample(Car)
+struct Car {
+  struct hot { int year; int speed; };
+  struct cold { std::string make; std::string model; };
+
+  static void accelerate(hot& h)
+  { ++h.speed; }
+
+  static std::string describe(hot const& h, cold const& c)
+  { return c.make + " " + c.model + " (" + std::to_string(h.year) + ")"; }
+};
+// end-sample
+
+// sample(vtable)
+struct vtable {
+  void (*accelerate)(void* hot, void* cold);
+  std::string (*describe)(void const* hot, void const* cold);
+  void (*copy)(void* hot, void const* other_hot,      // skip-sample
+               void** cold, void const* other_cold);  // skip-sample
+  void (*move)(void* hot, void* other_hot);           // skip-sample
+  void (*destroy)(void* hot, void* cold);             // skip-sample
+  int (*speed)(void const* hot);                      // skip-sample
+};
+
+template <typename T>
+inline constexpr vtable vtable_for = {
+  [](void* hot, void* cold) {
+    auto& h = *static_cast<typename T::hot*>(hot);
+    if constexpr (std::is_invocable_v<decltype(T::accelerate), typename T::hot&>)
+      T::accelerate(h);
+    else
+      T::accelerate(h, *static_cast<typename T::cold*>(cold));
+  },
+
+  [](void const* hot, void const* cold) -> std::string {
+    auto const& h = *static_cast<typename T::hot const*>(hot);
+    if constexpr (std::is_invocable_v<decltype(T::describe), typename T::hot const&>)
+      return T::describe(h);
+    else
+      return T::describe(h, *static_cast<typename T::cold const*>(cold));
+  }
+  ,                                                          // skip-sample
+  [](void* hot, void const* other_hot,                       // skip-sample
+     void** cold, void const* other_cold) {                  // skip-sample
+    using Cold = typename T::cold;                           // skip-sample
+    if constexpr (std::is_empty_v<Cold>)                     // skip-sample
+      *cold = nullptr;                                       // skip-sample
+    else                                                     // skip-sample
+      *cold = new Cold(                                      // skip-sample
+        *static_cast<Cold const*>(other_cold));              // skip-sample
+    new (hot) typename T::hot(                               // skip-sample
+      *static_cast<typename T::hot const*>(other_hot));      // skip-sample
+  },                                                         // skip-sample
+                                                             // skip-sample
+  [](void* hot, void* other_hot) {                           // skip-sample
+    using Hot = typename T::hot;                             // skip-sample
+    new (hot) Hot(                                           // skip-sample
+      std::move(*static_cast<Hot*>(other_hot)));             // skip-sample
+  },                                                         // skip-sample
+                                                             // skip-sample
+  [](void* hot, void* cold) {                                // skip-sample
+    using Hot = typename T::hot;                             // skip-sample
+    static_cast<Hot*>(hot)->~Hot();                          // skip-sample
+    delete static_cast<typename T::cold*>(cold);             // skip-sample
+  },                                                         // skip-sample
+                                                             // skip-sample
+  [](void const* hot) {                                      // skip-sample
+    return static_cast<typename T::hot const*>(hot)->speed;  // skip-sample
+  }                                                          // skip-sample
+};
+// end-sample
+
+// sample(Vehicle)
+class Vehicle {
+  vtable const* vptr_;
+  void* cold_;
+  std::aligned_storage_t<16, alignof(void*)> hot_;
+
+public:
+  template <typename Any>
+  Vehicle(std::in_place_type_t<Any>, typename Any::hot hot, typename Any::cold cold)
+    : vptr_{&vtable_for<Any>}, cold_{nullptr}
+  {
+    static_assert(sizeof(typename Any::hot) <= sizeof(hot_) &&
+                  alignof(typename Any::hot) <= alignof(decltype(hot_)),
+      "the hot part of the object must fit in the handle");
+    static_assert(!std::is_empty_v<typename Any::cold> ||                        // skip-sample
+      (std::is_invocable_v<decltype(Any::accelerate), typename Any::hot&> &&     // skip-sample
+       std::is_invocable_v<decltype(Any::describe), typename Any::hot const&>),  // skip-sample
+      "a type without cold data must only use its hot half");                    // skip-sample
+    if constexpr (!std::is_empty_v<typename Any::cold>)
+      cold_ = new typename Any::cold(std::move(cold));
+    new (&hot_) typename Any::hot(std::move(hot));
+  }
+
+  void accelerate()
+  { vptr_->accelerate(&hot_, cold_); }
+
+  std::string describe() const
+  { return vptr_->describe(&hot_, cold_); }
+// end-sample
+
+  int speed() const
+  { return vptr_->speed(&hot_); }
+
+  // The remote allocation, which is null for a type without cold data
+  void const* cold() const
+  { return cold_; }
+
+  Vehicle(Vehicle const& other) : vptr_{other.vptr_} {
+    vptr_->copy(&hot_, &other.hot_, &cold_, other.cold_);
+  }
+
+  // A moved-from Vehicle can only be destroyed.
+  Vehicle(Vehicle&& other) noexcept
+    : vptr_{other.vptr_}, cold_{std::exchange(other.cold_, nullptr)}
+  {
+    vptr_->move(&hot_, &other.hot_);
+  }
+
+  Vehicle& operator=(Vehicle const&) = delete;
+  Vehicle& operator=(Vehicle&&) = delete;
+
+  ~Vehicle()
+  { vptr_->destroy(&hot_, cold_); }
+};
+
+
+//////////////////////////////////////////////////////////////////////////////
+// A type whose every method needs both halves
+struct Truck {
+  struct hot { int year; int speed; };
+  struct cold { std::string make; std::vector<std::string> cargo; };
+
+  static void accelerate(hot& h, cold const& c)
+  { h.speed += c.cargo.empty() ? 2 : 1; }
+
+  static std::string describe(hot const& h, cold const& c)
+  { return c.make + " (" + std::to_string(h.year) + ")"; }
+};
+
+// A type whose methods only need the hot half, and which has no cold data
+struct Bike {
+  struct hot { int year; int speed; };
+  struct cold { };
+
+  static void accelerate(hot& h)
+  { h.speed += 3; }
+
+  static std::string describe(hot const& h)
+  { return "Bike (" + std::to_string(h.year) + ")"; }
+};
+
+int main() {
+  static_assert(sizeof(Vehicle) == 32, "");
+
+  std::vector<Vehicle> vehicles;
+  vehicles.emplace_back(std::in_place_type<Car>, Car::hot{2017, 0}, Car::cold{"Audi", "A4"});
+  vehicles.emplace_back(std::in_place_type<Truck>, Truck::hot{2015, 0}, Truck::cold{"Chevrolet", {}});
+  vehicles.emplace_back(std::in_place_type<Bike>, Bike::hot{2018, 0}, Bike::cold{});
+
+  for (auto& vehicle : vehicles)
+    vehicle.accelerate();
+
+  assert(vehicles[0].speed() == 1);
+  assert(vehicles[1].speed() == 2);
+  assert(vehicles[2].speed() == 3);
+
+  assert(vehicles[0].describe() == "Audi A4 (2017)");
+  assert(vehicles[1].describe() == "Chevrolet (2015)");
+  assert(vehicles[2].describe() == "Bike (2018)");
+
+  // The Bike was never given a cold allocation, so calling its methods could
+  // not have dereferenced one.
+  assert(vehicles[0].cold() != nullptr);
+  assert(vehicles[2].cold() == nullptr);
+
+  Vehicle copy = vehicles[0];
+  copy.accelerate();
+  assert(copy.speed() == 2);
+  assert(vehicles[0].speed() == 1);
+  assert(copy.describe() == "Audi A4 (2017)");
+
+  Vehicle bike = vehicles[2];
+  bike.accelerate();
+  assert(bike.speed() == 6);
+  assert(bike.cold() == nullptr);
+  assert(bike.describe() == "Bike (2018)");
+}
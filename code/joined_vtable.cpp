@@ -1,72 +1,16 @@
 // Copyright Louis Dionne 2018
 // Distributed under the Boost Software License, Version 1.0.
 
+#include "joined_vtable.hpp"
+
+#include <cassert>
 #include <cstddef>
 #include <cstdlib>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
-
-
-// sample(vtable)
-struct vtable {
-  void (*delete_)(void* this_);
-  // ...
-  void* (*clone)(void const* other); // skip-sample
-};
-
-template <typename T>
-vtable const vtable_for = {
-  [](void* this_) {
-    delete static_cast<T*>(this_);
-  }
-  // ...
-  ,                                               // skip-sample
-  [](void const* this_) -> void* {                // skip-sample
-    return new T(*static_cast<T const*>(this_));  // skip-sample
-  }                                               // skip-sample
-};
-// end-sample
-
-// sample(joined_vtable)
-struct joined_vtable {
-  vtable const* const remote;
-  void (*accelerate)(void* this_);
-};
-
-template <typename T>
-joined_vtable const joined_vtable_for = {
-  &vtable_for<T>,
-  [](void* this_) {
-    static_cast<T*>(this_)->accelerate();
-  }
-};
-// end-sample
-
-// sample(Vehicle)
-class Vehicle {
-  joined_vtable const vtbl_;
-  void* ptr_;
-
-public:
-  template <typename Any>
-  Vehicle(Any vehicle)
-    : vtbl_{joined_vtable_for<Any>}
-    , ptr_{new Any(vehicle)}
-  { }
-                                                      // skip-sample
-  Vehicle(Vehicle const& other)                       // skip-sample
-    : vtbl_{other.vtbl_}                              // skip-sample
-    , ptr_{other.vtbl_.remote->clone(other.ptr_)}     // skip-sample
-  { }                                                 // skip-sample
-
-  void accelerate()
-  { vtbl_.accelerate(ptr_); }
-
-  ~Vehicle()
-  { vtbl_.remote->delete_(ptr_); }
-};
-// end-sample
+using joined_vtable::Vehicle;
 
 
 //////////////////////////////////////////////////////////////////////////////
@@ -99,5 +43,12 @@ int main() {
   for (auto& vehicle : vehicles) {
     vehicle.accelerate();
   }
+
+  assert(vehicles[0].is<Car>() && !vehicles[0].is<Truck>());
+  assert(vehicles[1].try_as<Truck>()->make == "Chevrolet");
+  assert(vehicles[2].try_as<Car>() == nullptr);
+
+  Vehicle ford{std::in_place_type<Truck>, "Ford", 2009};          // skip-sample
+  assert(ford.try_as<Truck>()->year == 2009);                     // skip-sample
 }
 // end-sample
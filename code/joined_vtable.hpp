@@ -0,0 +1,91 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#ifndef JOINED_VTABLE_HPP
+#define JOINED_VTABLE_HPP
+
+#include <new>
+#include <utility>
+
+
+namespace joined_vtable {
+// sample(vtable)
+struct vtable {
+  void (*delete_)(void* this_);
+  // ...
+  void* (*clone)(void const* other); // skip-sample
+};
+
+template <typename T>
+inline constexpr vtable vtable_for = {
+  [](void* this_) {
+    delete static_cast<T*>(this_);
+  }
+  // ...
+  ,                                               // skip-sample
+  [](void const* this_) -> void* {                // skip-sample
+    return new T(*static_cast<T const*>(this_));  // skip-sample
+  }                                               // skip-sample
+};
+// end-sample
+
+// sample(joined_vtable)
+struct joined_vtable {
+  vtable const* const remote;
+  void (*accelerate)(void* this_);
+};
+
+template <typename T>
+inline constexpr joined_vtable joined_vtable_for = {
+  &vtable_for<T>,
+  [](void* this_) {
+    static_cast<T*>(this_)->accelerate();
+  }
+};
+// end-sample
+
+// sample(Vehicle)
+class Vehicle {
+  joined_vtable const vtbl_;
+  void* ptr_;
+
+public:
+  template <typename Any>
+  Vehicle(Any vehicle)
+    : vtbl_{joined_vtable_for<Any>}
+    , ptr_{new Any(std::move(vehicle))}
+  { }
+                                                      // skip-sample
+  template <typename Any, typename ...Args>           // skip-sample
+  Vehicle(std::in_place_type_t<Any>, Args&& ...args)  // skip-sample
+    : vtbl_{joined_vtable_for<Any>}                   // skip-sample
+    , ptr_{new Any{std::forward<Args>(args)...}}      // skip-sample
+  { }                                                 // skip-sample
+                                                      // skip-sample
+  Vehicle(Vehicle const& other)                       // skip-sample
+    : vtbl_{other.vtbl_}                              // skip-sample
+    , ptr_{other.vtbl_.remote->clone(other.ptr_)}     // skip-sample
+  { }                                                 // skip-sample
+
+  void accelerate()
+  { vtbl_.accelerate(ptr_); }
+                                                               // skip-sample
+  template <typename T>                                        // skip-sample
+  bool is() const                                              // skip-sample
+  { return vtbl_.remote == &vtable_for<T>; }                   // skip-sample
+                                                               // skip-sample
+  template <typename T>                                        // skip-sample
+  T* try_as()                                                  // skip-sample
+  { return is<T>() ? static_cast<T*>(ptr_) : nullptr; }        // skip-sample
+                                                               // skip-sample
+  template <typename T>                                        // skip-sample
+  T const* try_as() const                                      // skip-sample
+  { return is<T>() ? static_cast<T const*>(ptr_) : nullptr; }  // skip-sample
+
+  ~Vehicle()
+  { vtbl_.remote->delete_(ptr_); }
+};
+// end-sample
+} // end namespace joined_vtable
+
+#endif // header guard
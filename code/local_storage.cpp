@@ -1,39 +1,15 @@
 // Copyright Louis Dionne 2018
 // Distributed under the Boost Software License, Version 1.0.
 
-#include "vtable.hpp"
+#include "local_storage.hpp"
 
+#include <cassert>
 #include <cstdlib>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
-
-
-// sample(Vehicle)
-class Vehicle {
-  vtable const* const vptr_;
-  std::aligned_storage_t<64> buffer_;
-
-public:
-  template <typename Any>
-  Vehicle(Any vehicle) : vptr_{&vtable_for<Any>} {
-    static_assert(sizeof(Any) <= sizeof(buffer_),
-      "can't hold such a large object in a Vehicle");
-    new (&buffer_) Any(vehicle);
-  }
-                                                        // skip-sample
-  Vehicle(Vehicle const& other) : vptr_{other.vptr_} {  // skip-sample
-    other.vptr_->copy(&buffer_, &other.buffer_);        // skip-sample
-  }                                                     // skip-sample
-
-  void accelerate()
-  { vptr_->accelerate(&buffer_); }
-
-  ~Vehicle()
-  { vptr_->dtor(&buffer_); }
-};
-// end-sample
-
+using local_storage::Vehicle;
 
 
 //////////////////////////////////////////////////////////////////////////////
@@ -66,5 +42,22 @@ int main() {
   for (auto& vehicle : vehicles) {
     vehicle.accelerate();
   }
+
+  assert(vehicles[0].is<Car>() && !vehicles[0].is<Truck>());
+  assert(vehicles[1].try_as<Truck>()->make == "Chevrolet");
+  assert(vehicles[2].try_as<Car>() == nullptr);
+
+  Vehicle audi = Car{"Audi", 2017};
+  audi = vehicles[2];
+  assert(audi.try_as<Plane>()->model == "747");
+  audi = Vehicle{Car{"Audi", 2017}};
+  swap(audi, vehicles[1]);
+  assert(audi.try_as<Truck>()->make == "Chevrolet");
+  assert(vehicles[1].try_as<Car>()->make == "Audi");
+  swap(vehicles[0], vehicles[1]);
+  assert(vehicles[0].try_as<Car>()->make == "Audi" && vehicles[0].try_as<Car>()->year == 2017);
+
+  Vehicle ford{std::in_place_type<Truck>, "Ford", 2009};          // skip-sample
+  assert(ford.try_as<Truck>()->year == 2009);                     // skip-sample
 }
 // end-sample
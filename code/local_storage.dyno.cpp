@@ -5,20 +5,36 @@
 
 #include <dyno.hpp>
 
+#include <cassert>
 #include <cstdlib>
 #include <iostream>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 using namespace dyno::literals;
 
 
 // sample(Vehicle)
 struct Vehicle {
-  template <typename Any>
-  Vehicle(Any vehicle) : poly_{vehicle} { }
+  template <typename Any, typename = std::enable_if_t<
+    !std::is_same<std::decay_t<Any>, Vehicle>::value>>
+  Vehicle(Any&& vehicle) : poly_{std::forward<Any>(vehicle)} { }
 
   void accelerate()
   { poly_.virtual_("accelerate"_s)(poly_); }
+                                                                             // skip-sample
+  template <typename T>                                                      // skip-sample
+  bool is() const                                                            // skip-sample
+  { return poly_.virtual_("type_id"_s)(poly_) == &vehicle_type_id<T>; }      // skip-sample
+                                                                             // skip-sample
+  template <typename T>                                                      // skip-sample
+  T* try_as()                                                                // skip-sample
+  { return is<T>() ? static_cast<T*>(poly_.unsafe_get()) : nullptr; }        // skip-sample
+                                                                             // skip-sample
+  template <typename T>                                                      // skip-sample
+  T const* try_as() const                                                    // skip-sample
+  { return is<T>() ? static_cast<T const*>(poly_.unsafe_get()) : nullptr; }  // skip-sample
 
 private:
   dyno::poly<IVehicle, dyno::local_storage<64>> poly_;
@@ -57,5 +73,9 @@ int main() {
   for (auto& vehicle : vehicles) {
     vehicle.accelerate();
   }
+  Vehicle ford = Truck{"Ford", 2009};                             // skip-sample
+  assert(ford.is<Truck>() && !ford.is<Car>());                    // skip-sample
+  assert(ford.try_as<Truck>()->year == 2009);                     // skip-sample
+  assert(ford.try_as<Car>() == nullptr);                          // skip-sample
 }
 // end-sample
@@ -0,0 +1,107 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#ifndef LOCAL_STORAGE_HPP
+#define LOCAL_STORAGE_HPP
+
+#include "vtable.hpp"
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace local_storage {
+// sample(Vehicle)
+class Vehicle {
+  vtable const* vptr_;
+  std::aligned_storage_t<64> buffer_;
+
+public:
+  template <typename Any>
+  Vehicle(Any vehicle) : vptr_{&vtable_for<Any>} {
+    static_assert(sizeof(Any) <= sizeof(buffer_),
+      "can't hold such a large object in a Vehicle");
+    new (&buffer_) Any(std::move(vehicle));
+  }
+                                                        // skip-sample
+  template <typename Any, typename ...Args>             // skip-sample
+  Vehicle(std::in_place_type_t<Any>, Args&& ...args)    // skip-sample
+    : vptr_{&vtable_for<Any>}                           // skip-sample
+  {                                                     // skip-sample
+    static_assert(sizeof(Any) <= sizeof(buffer_),       // skip-sample
+      "can't hold such a large object in a Vehicle");   // skip-sample
+    new (&buffer_) Any{std::forward<Args>(args)...};    // skip-sample
+  }                                                     // skip-sample
+                                                        // skip-sample
+  Vehicle(Vehicle const& other) : vptr_{other.vptr_} {  // skip-sample
+    other.vptr_->copy(&buffer_, &other.buffer_);        // skip-sample
+  }                                                     // skip-sample
+                                                                       // skip-sample
+  Vehicle(Vehicle&& other) noexcept : vptr_{other.vptr_} {             // skip-sample
+    other.vptr_->move(&buffer_, &other.buffer_);                       // skip-sample
+  }                                                                    // skip-sample
+                                                                       // skip-sample
+  // Same-type assignment uses the type's own operator= in place       // skip-sample
+  Vehicle& operator=(Vehicle const& other) {                           // skip-sample
+    if (vptr_ == other.vptr_) {                                        // skip-sample
+      vptr_->copy_assign(&buffer_, &other.buffer_);                    // skip-sample
+    } else {                                                           // skip-sample
+      Vehicle copy{other};                                             // skip-sample
+      *this = std::move(copy);                                         // skip-sample
+    }                                                                  // skip-sample
+    return *this;                                                      // skip-sample
+  }                                                                    // skip-sample
+                                                                       // skip-sample
+  Vehicle& operator=(Vehicle&& other) noexcept {                       // skip-sample
+    if (vptr_ == other.vptr_) {                                        // skip-sample
+      vptr_->move_assign(&buffer_, &other.buffer_);                    // skip-sample
+    } else {                                                           // skip-sample
+      vptr_->dtor(&buffer_);                                           // skip-sample
+      vptr_ = other.vptr_;                                             // skip-sample
+      vptr_->move(&buffer_, &other.buffer_);                           // skip-sample
+    }                                                                  // skip-sample
+    return *this;                                                      // skip-sample
+  }                                                                    // skip-sample
+                                                                       // skip-sample
+  // Objects of different types are swapped through a stack buffer     // skip-sample
+  friend void swap(Vehicle& a, Vehicle& b) noexcept {                  // skip-sample
+    if (a.vptr_ == b.vptr_) {                                          // skip-sample
+      a.vptr_->swap(&a.buffer_, &b.buffer_);                           // skip-sample
+    } else {                                                           // skip-sample
+      decltype(buffer_) tmp;                                           // skip-sample
+      a.vptr_->move(&tmp, &a.buffer_);                                 // skip-sample
+      a.vptr_->dtor(&a.buffer_);                                       // skip-sample
+      b.vptr_->move(&a.buffer_, &b.buffer_);                           // skip-sample
+      b.vptr_->dtor(&b.buffer_);                                       // skip-sample
+      a.vptr_->move(&b.buffer_, &tmp);                                 // skip-sample
+      a.vptr_->dtor(&tmp);                                             // skip-sample
+      std::swap(a.vptr_, b.vptr_);                                     // skip-sample
+    }                                                                  // skip-sample
+  }                                                                    // skip-sample
+
+  void accelerate()
+  { vptr_->accelerate(&buffer_); }
+                                                                       // skip-sample
+  template <typename T>                                                // skip-sample
+  bool is() const                                                      // skip-sample
+  { return vptr_ == &vtable_for<T>; }                                  // skip-sample
+                                                                       // skip-sample
+  template <typename T>                                                // skip-sample
+  T* try_as()                                                          // skip-sample
+  { return is<T>() ? reinterpret_cast<T*>(&buffer_) : nullptr; }       // skip-sample
+                                                                       // skip-sample
+  template <typename T>                                                // skip-sample
+  T const* try_as() const                                              // skip-sample
+  { return is<T>() ? reinterpret_cast<T const*>(&buffer_) : nullptr; } // skip-sample
+                                                                       // skip-sample
+  vtable const* vptr() const                                           // skip-sample
+  { return vptr_; }                                                    // skip-sample
+
+  ~Vehicle()
+  { vptr_->dtor(&buffer_); }
+};
+// end-sample
+} // end namespace local_storage
+
+#endif // header guard
@@ -1,39 +1,16 @@
 // Copyright Louis Dionne 2018
 // Distributed under the Boost Software License, Version 1.0.
 
-#include "vtable.hpp"
+#include "local_vtable.hpp"
 
+#include <cassert>
 #include <cstddef>
 #include <cstdlib>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
-
-
-// sample(Vehicle)
-struct Vehicle {
-  template <typename Any>
-  Vehicle(Any vehicle)
-    : vtbl_{vtable_for<Any>}
-    , ptr_{new Any(vehicle)}
-  { }
-                                                      // skip-sample
-  Vehicle(Vehicle const& other)                       // skip-sample
-    : vtbl_{other.vtbl_}                              // skip-sample
-    , ptr_{other.vtbl_.clone(other.ptr_)}             // skip-sample
-  { }                                                 // skip-sample
-
-  void accelerate()
-  { vtbl_.accelerate(ptr_); }
-
-  ~Vehicle()
-  { vtbl_.delete_(ptr_); }
-
-private:
-  vtable const vtbl_; // <= not a pointer!
-  void* ptr_;
-};
-// end-sample
+using local_vtable::Vehicle;
 
 
 //////////////////////////////////////////////////////////////////////////////
@@ -66,5 +43,9 @@ int main() {
   for (auto& vehicle : vehicles) {
     vehicle.accelerate();
   }
+
+  vehicles.emplace_back(std::in_place_type<Truck>, "Ford", 2009); // skip-sample
+  assert(vehicles.size() == 4);                                   // skip-sample
+  vehicles.back().accelerate();                                   // skip-sample
 }
 // end-sample
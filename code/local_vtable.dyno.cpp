@@ -8,14 +8,17 @@
 #include <cstdlib>
 #include <iostream>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 using namespace dyno::literals;
 
 
 // sample(Vehicle)
 struct Vehicle {
-  template <typename Any>
-  Vehicle(Any vehicle) : poly_{vehicle} { }
+  template <typename Any, typename = std::enable_if_t<
+    !std::is_same<std::decay_t<Any>, Vehicle>::value>>
+  Vehicle(Any&& vehicle) : poly_{std::forward<Any>(vehicle)} { }
 
   void accelerate()
   { poly_.virtual_("accelerate"_s)(poly_); }
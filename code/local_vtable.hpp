@@ -0,0 +1,45 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#ifndef LOCAL_VTABLE_HPP
+#define LOCAL_VTABLE_HPP
+
+#include "vtable.hpp"
+
+#include <utility>
+
+
+namespace local_vtable {
+// sample(Vehicle)
+struct Vehicle {
+  template <typename Any>
+  Vehicle(Any vehicle)
+    : vtbl_{vtable_for<Any>}
+    , ptr_{new Any(std::move(vehicle))}
+  { }
+                                                      // skip-sample
+  template <typename Any, typename ...Args>           // skip-sample
+  Vehicle(std::in_place_type_t<Any>, Args&& ...args)  // skip-sample
+    : vtbl_{vtable_for<Any>}                          // skip-sample
+    , ptr_{new Any{std::forward<Args>(args)...}}      // skip-sample
+  { }                                                 // skip-sample
+                                                      // skip-sample
+  Vehicle(Vehicle const& other)                       // skip-sample
+    : vtbl_{other.vtbl_}                              // skip-sample
+    , ptr_{other.vtbl_.clone(other.ptr_)}             // skip-sample
+  { }                                                 // skip-sample
+
+  void accelerate()
+  { vtbl_.accelerate(ptr_); }
+
+  ~Vehicle()
+  { vtbl_.delete_(ptr_); }
+
+private:
+  vtable const vtbl_; // <= not a pointer!
+  void* ptr_;
+};
+// end-sample
+} // end namespace local_vtable
+
+#endif // header guard
@@ -0,0 +1,317 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#include <array>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+// sample(vtable)
+struct vtable {
+  std::uint32_t type_id;
+  void (*accelerate)(void* this_);
+  void (*serialize)(void const* this_, void* out);
+  void (*copy)(void* p, void const* other); // skip-sample
+  void (*dtor)(void* this_);                // skip-sample
+};
+
+template <typename T>
+inline constexpr vtable vtable_for = {
+  T::type_id,
+
+  [](void* this_) {
+    static_cast<T*>(this_)->accelerate();
+  },
+
+  [](void const* this_, void* out) {
+    static_assert(std::is_trivially_copyable<T>{},
+      "only trivially copyable objects can be mapped from a file");
+    std::memcpy(out, this_, sizeof(T));
+  }
+  ,                                               // skip-sample
+  [](void* p, void const* other) {                // skip-sample
+    new (p) T(*static_cast<T const*>(other));     // skip-sample
+  },                                              // skip-sample
+                                                  // skip-sample
+  [](void* this_) {                               // skip-sample
+    static_cast<T*>(this_)->~T();                 // skip-sample
+  }                                               // skip-sample
+};
+// end-sample
+
+// Vtables can't be stored in a file, since their address changes from one
+// run to the next. Instead, records store a stable type ID, and the registry
+// maps it back to the vtable of the current process.
+// sample(registry)
+class type_registry {
+  std::array<vtable const*, 256> vtables_{};
+
+public:
+  template <typename T>
+  void add() {
+    static_assert(T::type_id < 256, "type IDs must be small integers");
+    vtables_[T::type_id] = &vtable_for<T>;
+  }
+
+  vtable const* find(std::uint32_t type_id) const
+  { return type_id < vtables_.size() ? vtables_[type_id] : nullptr; }
+};
+// end-sample
+
+
+//////////////////////////////////////////////////////////////////////////////
+// On-disk format: a header followed by fixed-size records, each one being a
+// type ID and a local-storage-style buffer. Records are laid out contiguously
+// and aligned on cache lines, so record i lives at a fixed offset.
+//////////////////////////////////////////////////////////////////////////////
+// sample(record)
+struct alignas(64) file_header {
+  char magic[8];
+  std::uint64_t count;
+  std::uint64_t record_size;
+};
+
+struct alignas(64) record {
+  std::uint32_t type_id;
+  alignas(16) unsigned char buffer[48];
+};
+// end-sample
+
+constexpr char fleet_magic[8] = {'V', 'F', 'L', 'E', 'E', 'T', '0', '1'};
+
+
+class Vehicle {
+  vtable const* const vptr_;
+  std::aligned_storage_t<sizeof(record::buffer), 16> buffer_;
+
+public:
+  template <typename Any>
+  Vehicle(Any vehicle) : vptr_{&vtable_for<Any>} {
+    static_assert(sizeof(Any) <= sizeof(buffer_),
+      "can't hold such a large object in a Vehicle");
+    new (&buffer_) Any(vehicle);
+  }
+
+  Vehicle(Vehicle const& other) : vptr_{other.vptr_} {
+    other.vptr_->copy(&buffer_, &other.buffer_);
+  }
+
+  void accelerate()
+  { vptr_->accelerate(&buffer_); }
+
+  void serialize(record& out) const {
+    out.type_id = vptr_->type_id;
+    vptr_->serialize(&buffer_, out.buffer);
+  }
+
+  ~Vehicle()
+  { vptr_->dtor(&buffer_); }
+};
+
+// sample(VehicleRef)
+class VehicleRef {
+  vtable const* const vptr_;
+  void* ref_;
+
+public:
+  VehicleRef(vtable const* vptr, void* ref)
+    : vptr_{vptr}, ref_{ref}
+  { }
+
+  void accelerate()
+  { vptr_->accelerate(ref_); }
+                                                                          // skip-sample
+  template <typename T>                                                   // skip-sample
+  T* try_as() const                                                       // skip-sample
+  { return vptr_ == &vtable_for<T> ? static_cast<T*>(ref_) : nullptr; }  // skip-sample
+};
+// end-sample
+
+void save(std::vector<Vehicle> const& vehicles, char const* path) {
+  std::FILE* file = std::fopen(path, "wb");
+  if (!file)
+    throw std::system_error{errno, std::generic_category(), path};
+
+  file_header header{};
+  std::memcpy(header.magic, fleet_magic, sizeof(fleet_magic));
+  header.count = vehicles.size();
+  header.record_size = sizeof(record);
+  bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+
+  for (Vehicle const& vehicle : vehicles) {
+    record r{};
+    vehicle.serialize(r);
+    ok = ok && std::fwrite(&r, sizeof(r), 1, file) == 1;
+  }
+
+  ok = (std::fclose(file) == 0) && ok;
+  if (!ok)
+    throw std::runtime_error{"could not write the fleet to the file"};
+}
+
+// A fleet mapped from a file. Opening it maps the file without reading it;
+// pages are only brought in when the corresponding vehicles are accessed.
+// The mapping is private, so vehicles can be modified without changing the
+// file.
+// sample(mapped_fleet)
+class mapped_fleet {
+  type_registry const& registry_;
+  void* data_ = nullptr;
+  std::size_t bytes_ = 0;
+  std::size_t count_ = 0;
+
+  record* records() const
+  { return reinterpret_cast<record*>(static_cast<file_header*>(data_) + 1); }
+
+public:
+  mapped_fleet(char const* path, type_registry const& registry)
+    : registry_{registry}
+  {
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+      throw std::system_error{errno, std::generic_category(), path};
+
+    struct stat st;
+    if (::fstat(fd, &st) < 0) {
+      int error = errno;
+      ::close(fd);
+      throw std::system_error{error, std::generic_category(), path};
+    }
+    bytes_ = static_cast<std::size_t>(st.st_size);
+    if (bytes_ < sizeof(file_header)) {
+      ::close(fd);
+      throw std::runtime_error{"not a fleet file"};
+    }
+
+    data_ = ::mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    int error = errno;
+    ::close(fd);
+    if (data_ == MAP_FAILED)
+      throw std::system_error{error, std::generic_category(), path};
+
+    auto const& header = *static_cast<file_header const*>(data_);
+    if (std::memcmp(header.magic, fleet_magic, sizeof(fleet_magic)) != 0 ||
+        header.record_size != sizeof(record) ||
+        header.count > (bytes_ - sizeof(file_header)) / sizeof(record)) {
+      ::munmap(data_, bytes_);
+      throw std::runtime_error{"not a fleet file"};
+    }
+    count_ = header.count;
+  }
+
+  mapped_fleet(mapped_fleet const&) = delete;
+  mapped_fleet& operator=(mapped_fleet const&) = delete;
+
+  ~mapped_fleet()
+  { ::munmap(data_, bytes_); }
+
+  std::size_t size() const { return count_; }
+
+  VehicleRef operator[](std::size_t i) const {
+    record& r = records()[i];
+    vtable const* vptr = registry_.find(r.type_id);
+    if (!vptr)
+      throw std::runtime_error{"unknown type in fleet file"};
+    return VehicleRef{vptr, r.buffer};
+  }
+};
+// end-sample
+
+
+//////////////////////////////////////////////////////////////////////////////
+// Objects that live in a file can't own heap memory, so their strings are
+// stored inline.
+struct Car {
+  static constexpr std::uint32_t type_id = 1;
+  char make[16];
+  int year;
+  int speed;
+  void accelerate() { ++speed; }
+};
+
+struct Truck {
+  static constexpr std::uint32_t type_id = 2;
+  char make[16];
+  int year;
+  int speed;
+  void accelerate() { speed += 2; }
+};
+
+struct Plane {
+  static constexpr std::uint32_t type_id = 3;
+  char make[16];
+  char model[16];
+  int speed;
+  void accelerate() { speed += 3; }
+};
+
+int main() {
+  type_registry registry;
+  registry.add<Car>();
+  registry.add<Truck>();
+  registry.add<Plane>();
+
+  char const* path = "mapped_storage.fleet";
+
+  {
+    std::vector<Vehicle> vehicles;
+    vehicles.push_back(Car{"Audi", 2017, 0});
+    vehicles.push_back(Truck{"Chevrolet", 2015, 0});
+    vehicles.push_back(Plane{"Boeing", "747", 0});
+    save(vehicles, path);
+  }
+
+  {
+    mapped_fleet vehicles{path, registry};
+    assert(vehicles.size() == 3);
+    for (std::size_t i = 0; i != vehicles.size(); ++i) {
+      vehicles[i].accelerate();
+      vehicles[i].accelerate();
+    }
+    assert(vehicles[0].try_as<Car>()->speed == 2 && vehicles[0].try_as<Car>()->year == 2017);
+    assert(vehicles[1].try_as<Truck>()->speed == 4 && vehicles[1].try_as<Truck>()->year == 2015);
+    assert(vehicles[2].try_as<Plane>()->speed == 6);
+    assert(vehicles[2].try_as<Car>() == nullptr);
+
+    // the objects are accessed right where they are in the mapping
+    // (reading the file directly is only done for testing purposes)
+    std::FILE* file = std::fopen(path, "rb");
+    file_header header;
+    record r;
+    std::size_t read = std::fread(&header, sizeof(header), 1, file);
+    read += std::fread(&r, sizeof(r), 1, file);
+    std::fclose(file);
+    assert(read == 2);
+    assert(r.type_id == Car::type_id);
+    Car saved;
+    std::memcpy(&saved, r.buffer, sizeof(Car));
+    assert(std::strcmp(saved.make, "Audi") == 0 && saved.speed == 0);
+  }
+
+  // a type that is not registered can't be loaded
+  {
+    type_registry cars_only;
+    cars_only.add<Car>();
+    mapped_fleet vehicles{path, cars_only};
+    vehicles[0].accelerate();
+    bool threw = false;
+    try { vehicles[1]; } catch (std::runtime_error const&) { threw = true; }
+    assert(threw);
+  }
+
+  std::remove(path);
+}
@@ -0,0 +1,80 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#include "memoizing_poly.hpp"
+#include "vtable.dyno.cow.hpp"
+
+#include <dyno.hpp>
+
+#include <cassert>
+#include <string>
+#include <utility>
+using namespace dyno::literals;
+
+
+// sample(Vehicle)
+struct Vehicle {
+  template <typename Any>
+  Vehicle(Any vehicle) : poly_{std::move(vehicle)} { }
+
+  void accelerate()
+  { poly_.call("accelerate"_s); }
+
+  bool is_stopped() const
+  { return poly_.call("is_stopped"_s); }
+
+private:
+  memoizing_poly<IVehicle, dyno::remote_storage,
+                 memoize<decltype("is_stopped"_s)>> poly_;
+};
+// end-sample
+
+
+//////////////////////////////////////////////////////////////////////////////
+int queries = 0;
+
+struct Car {
+  std::string make;
+  int speed;
+  void accelerate() { ++speed; }
+  bool is_stopped() const { ++queries; return speed == 0; }
+};
+
+int main() {
+  Vehicle const parked = Car{"Audi", 0};
+  assert(parked.is_stopped());
+  assert(parked.is_stopped());
+  assert(queries == 1);
+
+  Vehicle car = Car{"Audi", 0};
+  queries = 0;
+  assert(car.is_stopped());
+  assert(std::as_const(car).is_stopped());
+  assert(queries == 1);
+
+  // A mutation forgets the cached result
+  car.accelerate();
+  assert(!car.is_stopped());
+  assert(!car.is_stopped());
+  assert(queries == 2);
+
+  // Copies carry the cache along, and are invalidated independently
+  Vehicle copy = car;
+  assert(!copy.is_stopped());
+  assert(queries == 2);
+  copy.accelerate();
+  assert(!copy.is_stopped());
+  assert(queries == 3);
+
+  // Through a non-const handle, queries still use the cache, and only the
+  // methods taking a dyno::T& forget it
+  memoizing_poly<IVehicle, dyno::remote_storage,
+                 memoize<decltype("is_stopped"_s)>> poly = Car{"Ford", 0};
+  queries = 0;
+  assert(poly.call("is_stopped"_s));
+  assert(poly.call("is_stopped"_s));
+  assert(queries == 1);
+  poly.call("accelerate"_s);
+  assert(!poly.call("is_stopped"_s));
+  assert(queries == 2);
+}
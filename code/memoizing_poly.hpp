@@ -0,0 +1,102 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#ifndef MEMOIZING_POLY_HPP
+#define MEMOIZING_POLY_HPP
+
+#include <dyno.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+// The names of the methods whose results are cached by a memoizing_poly,
+// like memoize<decltype("is_stopped"_s)>.
+template <typename ...Names>
+struct memoize { };
+
+template <typename Concept, typename StoragePolicy, typename Memoized = memoize<>>
+class memoizing_poly;
+
+namespace detail {
+  template <typename Signature>
+  struct takes_const_self : std::false_type { };
+
+  template <typename R, typename ...Args>
+  struct takes_const_self<R (dyno::T const&, Args...)> : std::true_type { };
+} // end namespace detail
+
+// sample(memoizing_poly)
+// A dyno::poly that remembers the results of some of its const methods.
+//
+// The memoized methods must be pure queries taking no arguments: the first
+// call dispatches to the stored object and caches the result inside the
+// handle, and later calls return it without any dispatch. Calling a method
+// that the concept declares as taking `dyno::T&` is taken as a mutation, and
+// forgets every cached result.
+template <typename Concept, typename StoragePolicy, typename ...Names>
+class memoizing_poly<Concept, StoragePolicy, memoize<Names...>> {
+  using Poly = dyno::poly<Concept, StoragePolicy>;
+  Poly poly_;
+
+  template <typename Name>
+  using result = std::decay_t<decltype(
+    std::declval<Poly const&>().virtual_(Name{})(std::declval<Poly const&>())
+  )>;
+  mutable std::tuple<std::optional<result<Names>>...> cache_;
+
+  template <typename Name>
+  static constexpr std::size_t index_of() {
+    constexpr bool matches[] = {std::is_same<Name, Names>::value..., false};
+    std::size_t i = 0;
+    while (i != sizeof...(Names) && !matches[i])
+      ++i;
+    return i;
+  }
+
+  template <typename Name>
+  static constexpr bool is_mutating() {
+    using Signature = typename decltype(Concept{}.get_signature(Name{}))::type;
+    return !detail::takes_const_self<Signature>::value;
+  }
+
+public:
+  template <typename Any, typename RawAny = std::decay_t<Any>,
+            typename = std::enable_if_t<!std::is_same<RawAny, memoizing_poly>::value>>
+  memoizing_poly(Any&& any) : poly_{std::forward<Any>(any)} { }
+
+  template <typename Name, typename ...Args>
+  decltype(auto) call(Name name, Args&& ...args) const {
+    constexpr std::size_t i = index_of<Name>();
+    if constexpr (i != sizeof...(Names)) {
+      static_assert(sizeof...(Args) == 0, "memoized methods take no arguments");
+      auto& cached = std::get<i>(cache_);
+      if (!cached)
+        cached.emplace(poly_.virtual_(name)(poly_));
+      return result<Name>{*cached};
+    } else {
+      return poly_.virtual_(name)(poly_, std::forward<Args>(args)...);
+    }
+  }
+
+  template <typename Name, typename ...Args>
+  decltype(auto) call(Name name, Args&& ...args) {
+    if constexpr (index_of<Name>() != sizeof...(Names) || !is_mutating<Name>()) {
+      return std::as_const(*this).call(name, std::forward<Args>(args)...);
+    } else {
+      invalidate();
+      return poly_.virtual_(name)(poly_, std::forward<Args>(args)...);
+    }
+  }
+
+  // Forgets every cached result, for when the object was modified without
+  // going through the handle.
+  void invalidate() const
+  { cache_ = {}; }
+};
+// end-sample
+
+#endif // header guard
@@ -0,0 +1,337 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#ifndef METHOD_TABLE_HPP
+#define METHOD_TABLE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+// The calling convention of methods called by name: `args` points to an array
+// of pointers to the arguments, and the result is constructed in the storage
+// pointed to by `result` (which is null for methods returning void).
+// Arguments taken by value or by rvalue reference are moved from, so they
+// must point to copies or to rvalues of the caller (see invoke_packed).
+using invoker = void (*)(void* self, void* const* args, void* result);
+
+namespace detail {
+  template <typename T>
+  inline constexpr char type_id = 0;
+
+  enum class passing : unsigned char {
+    value, reference, const_reference, rvalue_reference
+  };
+
+  // A parameter of a method, as it is checked against an argument at runtime.
+  struct parameter {
+    void const* type;
+    passing how;
+  };
+
+  template <typename P, typename Raw = std::remove_cv_t<std::remove_reference_t<P>>>
+  constexpr parameter parameter_of = {
+    &type_id<Raw>,
+    std::is_rvalue_reference<P>::value ? passing::rvalue_reference :
+    !std::is_lvalue_reference<P>::value ? passing::value :
+    std::is_const<std::remove_reference_t<P>>::value ? passing::const_reference
+                                                      : passing::reference
+  };
+
+  // The signature of a method, with the references and cv-qualifiers of its
+  // parameters, so that an argument can't be moved into a reference to a
+  // non-const lvalue, or an lvalue into an rvalue reference.
+  struct signature_info {
+    void const* result;
+    std::size_t arity;
+    parameter const* parameters;
+  };
+
+  template <typename Signature>
+  struct signature_of;
+
+  template <typename R, typename ...Args>
+  struct signature_of<R(Args...)> {
+    static constexpr parameter parameters[sizeof...(Args) + 1] = {parameter_of<Args>..., {}};
+    static constexpr signature_info value = {&type_id<R>, sizeof...(Args), parameters};
+  };
+
+  template <typename R, typename ...Args, typename Body, typename Self, std::size_t ...I>
+  void unpack(Body const& body, Self& self, void* const* args, void* result,
+              R (*)(Args...), std::index_sequence<I...>) {
+    if constexpr (std::is_void<R>::value) {
+      body(self, static_cast<Args&&>(*static_cast<std::remove_reference_t<Args>*>(args[I]))...);
+    } else {
+      new (result) R(body(self,
+        static_cast<Args&&>(*static_cast<std::remove_reference_t<Args>*>(args[I]))...));
+    }
+  }
+
+  template <auto const& Table, typename T, std::size_t I>
+  void invoke(void* self, void* const* args, void* result) {
+    auto const& method = Table.template get<I>();
+    using Signature = typename std::decay_t<decltype(method)>::signature;
+    unpack(method.body, *static_cast<T*>(self), args, result, static_cast<Signature*>(nullptr),
+           std::make_index_sequence<signature_of<Signature>::value.arity>{});
+  }
+
+  template <auto const& Table, typename T, std::size_t ...I>
+  constexpr std::array<invoker, sizeof...(I)> make_invokers(std::index_sequence<I...>)
+  { return {{&invoke<Table, T, I>...}}; }
+
+  // The length and three characters of a name, which tell most names apart
+  // for a fraction of the cost of hashing them.
+  constexpr std::uint64_t sample(std::string_view name) {
+    if (name.empty())
+      return 0;
+    auto at = [&](std::size_t i) -> std::uint64_t { return static_cast<unsigned char>(name[i]); };
+    return name.size() | at(0) << 32 | at(name.size() / 2) << 40 | at(name.size() - 1) << 48;
+  }
+
+  template <typename Word>
+  Word load(char const* p) {
+    Word w;
+    std::memcpy(&w, p, sizeof(Word));
+    return w;
+  }
+
+  // Method names are short, and comparing them with two overlapping loads
+  // from each end avoids both the call to memcmp and a loop whose number of
+  // iterations depends on the name.
+  inline bool equal(std::string_view a, std::string_view b) {
+    std::size_t n = a.size();
+    if (n != b.size())
+      return false;
+    if (n >= 8 && n <= 16) {
+      return (load<std::uint64_t>(a.data()) == load<std::uint64_t>(b.data())) &
+             (load<std::uint64_t>(a.data() + n - 8) == load<std::uint64_t>(b.data() + n - 8));
+    }
+    if (n >= 4 && n < 8) {
+      return (load<std::uint32_t>(a.data()) == load<std::uint32_t>(b.data())) &
+             (load<std::uint32_t>(a.data() + n - 4) == load<std::uint32_t>(b.data() + n - 4));
+    }
+    return a == b;
+  }
+
+  // 64-bit FNV-1a
+  constexpr std::uint64_t hash(std::string_view name) {
+    std::uint64_t h = 14695981039346656037ull;
+    for (char c : name)
+      h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    return h;
+  }
+} // end namespace detail
+
+// A method of a concept: its name, its signature, and its implementation for
+// any type, which is called with the object and the arguments, like
+// method<void(int)>("set_speed", [](auto& self, int speed) { self.set_speed(speed); }).
+template <typename Signature, typename Body>
+struct method_t {
+  using signature = Signature;
+  std::string_view name;
+  Body body;
+};
+
+template <typename Signature, typename Body>
+constexpr method_t<Signature, Body> method(std::string_view name, Body body)
+{ return {name, body}; }
+
+// The methods of a concept, along with a perfect hash table from their names
+// to their index, computed at compile time. The vtable of a type is built
+// from the table with invokers_for, so the order and the signatures of the
+// methods are only written once.
+//
+// A name is reduced to a key made of its length and of three of its
+// characters, unless two methods have the same such key, in which case the
+// whole name is hashed with FNV-1a. The slot of a key is given by a
+// multiplicative hash `(key * multiplier) >> shift`, whose multiplier is
+// searched until no two names land in the same slot; there are at least twice
+// as many slots as names, so a multiplier is found after a few tries. A lookup
+// is then a few loads to compute the key, one load from the slots, and one
+// string comparison to reject names that are not methods of the concept.
+template <typename ...Methods>
+class method_table {
+  static constexpr std::size_t N = sizeof...(Methods);
+  static_assert(N > 0 && N < 255, "a method_table has between 1 and 254 methods");
+
+  static constexpr std::size_t slot_count() {
+    std::size_t slots = 2;
+    while (slots < 2 * N)
+      slots *= 2;
+    return slots;
+  }
+  static constexpr std::size_t shift() {
+    std::size_t bits = 0;
+    while ((std::size_t{1} << bits) != slot_count())
+      ++bits;
+    return 64 - bits;
+  }
+
+  std::tuple<Methods...> methods_;
+  std::string_view names_[N];
+  detail::signature_info const* signatures_[N];
+  bool sampled_ = true;
+  std::uint64_t multiplier_ = 0;
+  std::uint8_t slots_[slot_count()] = {}; // index + 1, or 0 when empty
+
+  constexpr std::uint64_t key(std::string_view name) const
+  { return sampled_ ? detail::sample(name) : detail::hash(name); }
+
+  constexpr std::size_t slot(std::uint64_t key, std::uint64_t multiplier) const
+  { return static_cast<std::size_t>((key * multiplier) >> shift()); }
+
+public:
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  constexpr explicit method_table(Methods ...methods)
+    : methods_{methods...}, names_{methods.name...}
+    , signatures_{&detail::signature_of<typename Methods::signature>::value...}
+  {
+    for (std::size_t i = 0; i != N; ++i) {
+      for (std::size_t j = 0; j != i; ++j) {
+        if (names_[i] == names_[j])
+          throw std::logic_error{"two methods have the same name"};
+        if (detail::sample(names_[i]) == detail::sample(names_[j]))
+          sampled_ = false;
+      }
+    }
+    std::uint64_t keys[N] = {};
+    for (std::size_t i = 0; i != N; ++i)
+      keys[i] = key(names_[i]);
+
+    for (std::uint64_t multiplier = 0x9E3779B97F4A7C15ull; ; multiplier += 2) {
+      std::uint8_t slots[slot_count()] = {};
+      std::size_t i = 0;
+      for (; i != N && slots[slot(keys[i], multiplier)] == 0; ++i)
+        slots[slot(keys[i], multiplier)] = static_cast<std::uint8_t>(i + 1);
+      if (i == N) {
+        multiplier_ = multiplier;
+        for (std::size_t s = 0; s != slot_count(); ++s)
+          slots_[s] = slots[s];
+        return;
+      }
+    }
+  }
+
+  // Index of the method called `name`, in the order the methods were given,
+  // or npos when there is none.
+  std::size_t find(std::string_view name) const {
+    std::size_t i = slots_[slot(key(name), multiplier_)];
+    return i != 0 && detail::equal(names_[i - 1], name) ? i - 1 : npos;
+  }
+
+  constexpr std::string_view name(std::size_t i) const
+  { return names_[i]; }
+
+  constexpr detail::signature_info const& signature(std::size_t i) const
+  { return *signatures_[i]; }
+
+  template <std::size_t I>
+  constexpr auto const& get() const
+  { return std::get<I>(methods_); }
+
+  static constexpr std::size_t size()
+  { return N; }
+};
+
+// The invokers of the methods of `Table` for objects of type `T`, in the
+// order of the table.
+template <auto const& Table, typename T>
+inline constexpr auto invokers_for = detail::make_invokers<Table, T>(
+  std::make_index_sequence<std::decay_t<decltype(Table)>::size()>{});
+
+namespace detail {
+  // An argument as it is passed to an invoker: a pointer to the argument of
+  // the caller, or to a copy of it when the parameter is taken by value and
+  // the argument is an lvalue, which must not be moved from.
+  template <typename Arg>
+  class packed_argument {
+    using T = std::remove_cv_t<std::remove_reference_t<Arg>>;
+    static constexpr bool is_lvalue = std::is_lvalue_reference<Arg>::value;
+    static constexpr bool is_const = std::is_const<std::remove_reference_t<Arg>>::value;
+
+    std::optional<T> copy_;
+    void* pointer_;
+
+  public:
+    packed_argument(Arg&& arg, parameter const& p)
+      : pointer_{const_cast<void*>(static_cast<void const*>(std::addressof(arg)))}
+    {
+      if (p.type != &type_id<T>)
+        throw std::invalid_argument{"method called with the wrong argument types"};
+      switch (p.how) {
+        case passing::value:
+          if (is_lvalue || is_const) {
+            if constexpr (std::is_copy_constructible<T>::value)
+              copy_.emplace(arg);
+            else
+              throw std::invalid_argument{"a non-copyable lvalue can't be passed by value"};
+          }
+          break;
+        case passing::reference:
+          if (!is_lvalue || is_const)
+            throw std::invalid_argument{"only a non-const lvalue binds to a reference"};
+          break;
+        case passing::const_reference:
+          break;
+        case passing::rvalue_reference:
+          if (is_lvalue || is_const)
+            throw std::invalid_argument{"only a non-const rvalue binds to an rvalue reference"};
+          break;
+      }
+    }
+
+    void* get()
+    { return copy_ ? static_cast<void*>(&*copy_) : pointer_; }
+  };
+
+  template <typename R, typename ...Args, std::size_t ...I>
+  R invoke_packed(invoker f, void* self, signature_info const& signature,
+                  std::index_sequence<I...>, Args&& ...args) {
+    std::tuple<packed_argument<Args>...> arguments{
+      packed_argument<Args>{std::forward<Args>(args), signature.parameters[I]}...
+    };
+    void* packed[] = {std::get<I>(arguments).get()..., nullptr};
+    if constexpr (std::is_void<R>::value) {
+      f(self, packed, nullptr);
+    } else {
+      std::aligned_storage_t<sizeof(R), alignof(R)> storage;
+      f(self, packed, &storage);
+      R& result = *std::launder(reinterpret_cast<R*>(&storage));
+      R moved = std::move(result);
+      result.~R();
+      return moved;
+    }
+  }
+} // end namespace detail
+
+// Calls the method at index `i` of `table` through `invokers`, after checking
+// that it can be called as `R(Args...)`. Throws std::out_of_range if `i` is
+// npos, and std::invalid_argument if the result or the arguments don't match
+// the signature of the method.
+template <typename R, typename ...Methods, typename ...Args>
+R invoke_packed(method_table<Methods...> const& table, invoker const* invokers,
+                std::size_t i, void* self, Args&& ...args) {
+  if (i == table.npos)
+    throw std::out_of_range{"no method with that name"};
+  detail::signature_info const& signature = table.signature(i);
+  if (signature.result != &detail::type_id<R>)
+    throw std::invalid_argument{"method called with the wrong result type"};
+  if (signature.arity != sizeof...(Args))
+    throw std::invalid_argument{"method called with the wrong number of arguments"};
+  return detail::invoke_packed<R>(invokers[i], self, signature,
+                                  std::index_sequence_for<Args...>{},
+                                  std::forward<Args>(args)...);
+}
+
+#endif // header guard
@@ -0,0 +1,160 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#include "method_table.hpp"
+
+#include <array>
+#include <cassert>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+// A scripting or RPC layer only knows the name of the method to call at
+// runtime. The concept lists its methods once, with their implementation for
+// any type, and a perfect hash of their names is computed at compile time.
+//
+// sample(methods)
+constexpr method_table vehicle_methods{
+  method<void()>("accelerate", [](auto& self) { self.accelerate(); }),
+  method<int()>("speed", [](auto const& self) { return self.speed(); }),
+  method<void(int)>("set_speed", [](auto& self, int speed) { self.set_speed(speed); }),
+  method<std::string(std::string const&)>("describe",
+    [](auto const& self, std::string const& prefix) { return self.describe(prefix); })
+  ,                                                                       // skip-sample
+  method<void(std::string)>("rename",                                     // skip-sample
+    [](auto& self, std::string name) { self.name = std::move(name); }),   // skip-sample
+  method<void(std::string&)>("swap_name",                                 // skip-sample
+    [](auto& self, std::string& name) { self.name.swap(name); }),         // skip-sample
+  method<void(std::string&&)>("take_name",                                // skip-sample
+    [](auto& self, std::string&& name) { self.name = std::move(name); })  // skip-sample
+};
+// end-sample
+
+// The vtable of a type is built from the table, so the methods are in the
+// same order, with the calling convention of `invoker`.
+//
+// sample(vtable)
+struct vtable {
+  std::array<invoker, vehicle_methods.size()> methods;
+  void (*delete_)(void* this_);
+};
+
+template <typename T>
+inline constexpr vtable vtable_for = {
+  invokers_for<vehicle_methods, T>,
+
+  [](void* this_) {
+    delete static_cast<T*>(this_);
+  }
+};
+// end-sample
+
+// sample(Vehicle)
+class Vehicle {
+  vtable const* vptr_;
+  void* ptr_;
+
+public:
+  template <typename Any>
+  Vehicle(Any vehicle)
+    : vptr_{&vtable_for<Any>}
+    , ptr_{new Any(std::move(vehicle))}
+  { }
+
+  // One hash of `name`, one string comparison and one indirect call. Throws
+  // std::out_of_range if there is no such method, and std::invalid_argument
+  // if it can't be called as `R(Args...)`.
+  template <typename R = void, typename ...Args>
+  R invoke(std::string_view name, Args&& ...args) {
+    return invoke_packed<R>(vehicle_methods, vptr_->methods.data(),
+                            vehicle_methods.find(name), ptr_,
+                            std::forward<Args>(args)...);
+  }
+// end-sample
+
+  Vehicle(Vehicle&& other)
+    : vptr_{other.vptr_}
+    , ptr_{std::exchange(other.ptr_, nullptr)}
+  { }
+
+  ~Vehicle()
+  { if (ptr_) vptr_->delete_(ptr_); }
+};
+
+
+//////////////////////////////////////////////////////////////////////////////
+struct Car {
+  int speed_ = 0;
+  std::string name;
+  void accelerate() { speed_ += 1; }
+  int speed() const { return speed_; }
+  void set_speed(int speed) { speed_ = speed; }
+  std::string describe(std::string const& prefix) const { return prefix + "Car " + name; }
+};
+
+struct Truck {
+  long speed_ = 0;
+  std::string name;
+  void accelerate() { speed_ += 2; }
+  long speed() const { return speed_; }
+  void set_speed(long speed) { speed_ = speed; }
+  std::string describe(std::string const& prefix) const { return prefix + "Truck " + name; }
+};
+
+template <typename Exception, typename F>
+bool throws(F f) {
+  try { f(); } catch (Exception const&) { return true; }
+  return false;
+}
+
+int main() {
+  assert(vehicle_methods.find("set_speed") == 2);
+  assert(vehicle_methods.find("brake") == vehicle_methods.npos);
+  assert(vehicle_methods.find("") == vehicle_methods.npos);
+  assert(vehicle_methods.find("set_spee") == vehicle_methods.npos);
+
+  std::vector<Vehicle> vehicles;
+  vehicles.emplace_back(Car{});
+  vehicles.emplace_back(Truck{});
+
+  for (auto& vehicle : vehicles) {
+    vehicle.invoke("accelerate");
+    vehicle.invoke("accelerate");
+  }
+  assert(vehicles[0].invoke<int>("speed") == 2);
+  assert(vehicles[1].invoke<int>("speed") == 4);
+
+  // Truck's members take and return long, and the table converts
+  vehicles[1].invoke("set_speed", 7);
+  assert(vehicles[1].invoke<int>("speed") == 7);
+
+  // An lvalue passed by value is copied, not moved from
+  std::string name = "Audi";
+  vehicles[0].invoke("rename", name);
+  assert(name == "Audi");
+  std::string const prefix = "A ";
+  assert(vehicles[0].invoke<std::string>("describe", prefix) == "A Car Audi");
+  vehicles[0].invoke("rename", std::string{"Ford"});
+  assert(vehicles[0].invoke<std::string>("describe", prefix) == "A Car Ford");
+
+  // A reference binds to the lvalue of the caller
+  std::string other = "Volvo";
+  vehicles[0].invoke("swap_name", other);
+  assert(other == "Ford");
+  assert(throws<std::invalid_argument>([&] { vehicles[0].invoke("swap_name", std::string{"Kia"}); }));
+  assert(throws<std::invalid_argument>([&] { vehicles[0].invoke("swap_name", prefix); }));
+
+  // An rvalue reference only binds to rvalues
+  vehicles[1].invoke("take_name", std::string{"Mack"});
+  assert(vehicles[1].invoke<std::string>("describe", prefix) == "A Truck Mack");
+  assert(throws<std::invalid_argument>([&] { vehicles[1].invoke("take_name", name); }));
+  assert(name == "Audi");
+
+  assert(throws<std::out_of_range>([&] { vehicles[0].invoke("brake"); }));
+  assert(throws<std::invalid_argument>([&] { vehicles[0].invoke("set_speed", 1.5); }));
+  assert(throws<std::invalid_argument>([&] { vehicles[0].invoke("speed"); }));
+  assert(throws<std::invalid_argument>([&] { vehicles[0].invoke("set_speed"); }));
+}
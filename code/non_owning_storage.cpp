@@ -3,6 +3,7 @@
 
 #include "vtable.hpp"
 
+#include <cassert>
 #include <cstddef>
 #include <iostream>
 #include <string>
@@ -23,6 +24,18 @@ public:
 
   void accelerate()
   { vptr_->accelerate(ref_); }
+                                                               // skip-sample
+  template <typename T>                                        // skip-sample
+  bool is() const                                              // skip-sample
+  { return vptr_ == &vtable_for<T>; }                          // skip-sample
+                                                               // skip-sample
+  template <typename T>                                        // skip-sample
+  T* try_as()                                                  // skip-sample
+  { return is<T>() ? static_cast<T*>(ref_) : nullptr; }        // skip-sample
+                                                               // skip-sample
+  template <typename T>                                        // skip-sample
+  T const* try_as() const                                      // skip-sample
+  { return is<T>() ? static_cast<T const*>(ref_) : nullptr; }  // skip-sample
 };
 // end-sample
 
@@ -59,4 +72,8 @@ int main() {
   for (VehicleRef vehicle : vehicles) {
     vehicle.accelerate();
   }
+
+  assert(vehicles[0].is<Car>() && !vehicles[0].is<Truck>());
+  assert(vehicles[1].try_as<Truck>() == &chevrolet);
+  assert(vehicles[2].try_as<Car>() == nullptr);
 }
@@ -0,0 +1,75 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#include "local_storage.hpp"
+#include "parallel_for_each.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <vector>
+using local_storage::Vehicle;
+
+
+void accelerate_all(thread_pool& pool, std::vector<Vehicle>& vehicles) {
+  parallel_for_each(pool, vehicles, &Vehicle::accelerate);
+}
+
+void accelerate_all_grouped(thread_pool& pool, std::vector<Vehicle>& vehicles) {
+  parallel_for_each(pool, vehicles, &Vehicle::accelerate,
+                    [](Vehicle const& v) { return v.vptr(); });
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+std::atomic<int> cars{0}, trucks{0}, planes{0};
+
+struct Car {
+  std::string make;
+  int year;
+  void accelerate() { ++cars; }
+};
+
+struct Truck {
+  std::string make;
+  int year;
+  void accelerate() { ++trucks; }
+};
+
+struct Plane {
+  std::string make;
+  std::string model;
+  void accelerate() { ++planes; }
+};
+
+int main() {
+  std::vector<Vehicle> vehicles;
+  for (int i = 0; i != 10000; ++i) {
+    vehicles.push_back(Car{"Audi", 2017});
+    vehicles.push_back(Truck{"Chevrolet", 2015});
+    vehicles.push_back(Plane{"Boeing", "747"});
+  }
+
+  for (std::size_t threads : {1, 2, 4, 7}) {
+    thread_pool pool{threads};
+    cars = trucks = planes = 0;
+
+    accelerate_all(pool, vehicles);
+    assert(cars == 10000 && trucks == 10000 && planes == 10000);
+
+    accelerate_all_grouped(pool, vehicles);
+    assert(cars == 20000 && trucks == 20000 && planes == 20000);
+  }
+
+  // chunks always span whole cache lines
+  static_assert(chunk_elements<Vehicle>(1) * sizeof(Vehicle) % 64 == 0, "");
+  static_assert(chunk_elements<Vehicle>(1000) * sizeof(Vehicle) % 64 == 0, "");
+
+  // empty input runs nothing
+  {
+    thread_pool pool{3};
+    std::vector<Vehicle> none;
+    parallel_for_each(pool, none, &Vehicle::accelerate);
+  }
+}
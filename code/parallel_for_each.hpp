@@ -0,0 +1,241 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#ifndef PARALLEL_FOR_EACH_HPP
+#define PARALLEL_FOR_EACH_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+
+// A small pool of worker threads running one job at a time. A job is a range
+// of task indices [0, n). Each worker starts with its own contiguous slice of
+// that range and pops tasks from the front of it; once its slice is empty, it
+// steals tasks from the back of the other workers' slices. The thread calling
+// `run` participates as worker 0.
+class thread_pool {
+  static constexpr std::size_t cache_line = 64;
+
+  // front and back of a slice, packed so both ends can be updated atomically
+  struct alignas(cache_line) slice {
+    std::atomic<std::uint64_t> range{0};
+  };
+
+  static std::uint64_t pack(std::uint32_t front, std::uint32_t back)
+  { return (std::uint64_t{back} << 32) | front; }
+  static std::uint32_t front(std::uint64_t r) { return r & 0xffffffff; }
+  static std::uint32_t back(std::uint64_t r) { return r >> 32; }
+
+public:
+  explicit thread_pool(std::size_t threads = std::thread::hardware_concurrency())
+    : slices_{new slice[std::max<std::size_t>(threads, 1)]}
+    , size_{std::max<std::size_t>(threads, 1)}
+  {
+    for (std::size_t i = 1; i != size_; ++i)
+      workers_.emplace_back([this, i] { work(i); });
+  }
+
+  thread_pool(thread_pool const&) = delete;
+  thread_pool& operator=(thread_pool const&) = delete;
+
+  ~thread_pool() {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_)
+      worker.join();
+  }
+
+  std::size_t size() const { return size_; }
+
+  // Calls `task(i)` for every i in [0, n), and returns once all calls are done.
+  template <typename Task>
+  void run(std::size_t n, Task&& task) {
+    if (n == 0)
+      return;
+
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      task_ = std::ref(task);
+      pending_ = n;
+      ++generation_;
+    }
+
+    // Publishing the slices makes `task_` visible to whoever pops from them.
+    for (std::size_t i = 0; i != size_; ++i) {
+      auto first = static_cast<std::uint32_t>(n * i / size_);
+      auto last = static_cast<std::uint32_t>(n * (i + 1) / size_);
+      slices_[i].range.store(pack(first, last), std::memory_order_release);
+    }
+    wake_.notify_all();
+
+    drain(0);
+
+    std::unique_lock<std::mutex> lock{mutex_};
+    done_.wait(lock, [&] { return pending_ == 0; });
+    task_ = nullptr;
+  }
+
+private:
+  void work(std::size_t self) {
+    std::size_t seen = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock{mutex_};
+        wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+        if (stop_)
+          return;
+        seen = generation_;
+      }
+      drain(self);
+    }
+  }
+
+  void drain(std::size_t self) {
+    std::size_t completed = 0;
+    std::size_t task;
+    while (pop(self, task) || steal(self, task)) {
+      task_(task);
+      ++completed;
+    }
+
+    if (completed != 0) {
+      std::lock_guard<std::mutex> lock{mutex_};
+      pending_ -= completed;
+      if (pending_ == 0)
+        done_.notify_all();
+    }
+  }
+
+  bool pop(std::size_t self, std::size_t& task) {
+    auto& range = slices_[self].range;
+    auto r = range.load(std::memory_order_relaxed);
+    while (front(r) < back(r)) {
+      if (range.compare_exchange_weak(r, pack(front(r) + 1, back(r)),
+                                      std::memory_order_acquire)) {
+        task = front(r);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool steal(std::size_t self, std::size_t& task) {
+    for (std::size_t k = 1; k != size_; ++k) {
+      auto& range = slices_[(self + k) % size_].range;
+      auto r = range.load(std::memory_order_relaxed);
+      while (front(r) < back(r)) {
+        if (range.compare_exchange_weak(r, pack(front(r), back(r) - 1),
+                                        std::memory_order_acquire)) {
+          task = back(r) - 1;
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  std::unique_ptr<slice[]> slices_;
+  std::size_t size_;
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  std::function<void(std::size_t)> task_;
+  std::size_t pending_ = 0;
+  std::size_t generation_ = 0;
+  bool stop_ = false;
+};
+
+
+// Number of elements in a chunk, rounded up so that every chunk spans a whole
+// number of cache lines. Adjacent chunks then never share a cache line, and
+// threads working on neighbouring chunks don't falsely share anything.
+template <typename T>
+constexpr std::size_t chunk_elements(std::size_t wanted) {
+  std::size_t line = 64;
+  std::size_t step = line / std::gcd(line, sizeof(T));
+  return std::max<std::size_t>((wanted + step - 1) / step, 1) * step;
+}
+
+// Calls `std::invoke(method, vehicle)` on every element of `vehicles`, split
+// into chunks of about `chunk_size` elements and spread across `pool`.
+// `method` can be a pointer to member like `&Vehicle::accelerate`, which works
+// with any of the storage policies.
+template <typename Vehicle, typename Method>
+void parallel_for_each(thread_pool& pool, std::vector<Vehicle>& vehicles,
+                       Method method, std::size_t chunk_size = 1024)
+{
+  std::size_t const chunk = chunk_elements<Vehicle>(chunk_size);
+  std::size_t const chunks = (vehicles.size() + chunk - 1) / chunk;
+  Vehicle* const data = vehicles.data();
+  std::size_t const size = vehicles.size();
+
+  pool.run(chunks, [&](std::size_t c) {
+    Vehicle* first = data + c * chunk;
+    Vehicle* last = data + std::min(size, (c + 1) * chunk);
+    for (; first != last; ++first)
+      std::invoke(method, *first);
+  });
+}
+
+// Same as above, but elements of each chunk are dispatched grouped by
+// `vtable_of(vehicle)`, so that consecutive calls go through the same vtable
+// and the indirect branch is well predicted. Elements are not moved; instead,
+// each chunk is traversed once per distinct vtable it contains. Chunks with
+// more than `max_groups` distinct vtables are dispatched in order.
+template <typename Vehicle, typename Method, typename VTableOf>
+void parallel_for_each(thread_pool& pool, std::vector<Vehicle>& vehicles,
+                       Method method, VTableOf vtable_of,
+                       std::size_t chunk_size = 1024)
+{
+  constexpr std::size_t max_groups = 8;
+  std::size_t const chunk = chunk_elements<Vehicle>(chunk_size);
+  std::size_t const chunks = (vehicles.size() + chunk - 1) / chunk;
+  Vehicle* const data = vehicles.data();
+  std::size_t const size = vehicles.size();
+
+  pool.run(chunks, [&](std::size_t c) {
+    Vehicle* const first = data + c * chunk;
+    Vehicle* const last = data + std::min(size, (c + 1) * chunk);
+
+    using Key = decltype(vtable_of(*data));
+    Key groups[max_groups];
+    std::size_t ngroups = 0;
+    for (Vehicle* it = first; it != last && ngroups <= max_groups; ++it) {
+      Key key = vtable_of(*it);
+      if (std::find(groups, groups + ngroups, key) != groups + ngroups)
+        continue;
+      if (ngroups == max_groups) {
+        ++ngroups;
+        break;
+      }
+      groups[ngroups++] = key;
+    }
+
+    if (ngroups > max_groups) {
+      for (Vehicle* it = first; it != last; ++it)
+        std::invoke(method, *it);
+      return;
+    }
+
+    for (std::size_t g = 0; g != ngroups; ++g)
+      for (Vehicle* it = first; it != last; ++it)
+        if (vtable_of(*it) == groups[g])
+          std::invoke(method, *it);
+  });
+}
+
+#endif // header guard
@@ -0,0 +1,90 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#include "pipeline.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+int parse(std::string const& s) { return std::stoi(s); }
+bool is_even(int i) { return i % 2 == 0; }
+int square(int i) { return i * i; }
+
+std::vector<std::string> numbers(int n) {
+  std::vector<std::string> result;
+  for (int i = 0; i != n; ++i)
+    result.push_back(std::to_string(i));
+  return result;
+}
+
+// The expected output of parse -> is_even -> square on numbers(n)
+std::vector<int> expected(int n) {
+  std::vector<int> result;
+  for (int i = 0; i < n; i += 2)
+    result.push_back(i * i);
+  return result;
+}
+
+int main() {
+  // Fully fused, with a number of elements that is not a multiple of the
+  // batch size
+  {
+    std::vector<int> out;
+    auto p = make_pipeline<std::string, 8>()
+               .then(map(parse) | filter(is_even))
+               .then(map(square))
+               .sink([&](int i) { out.push_back(i); });
+    for (auto const& s : numbers(100))
+      p.push(s);
+    assert(out.size() == 48);
+    p.flush();
+    assert(out == expected(100));
+  }
+
+  // Every stage erased, one call per stage per batch
+  {
+    std::vector<int> out;
+    stage<std::string, int> parse_stage = erase<std::string>(map(parse));
+    stage<int, int> filter_stage = erase<int>(filter(is_even));
+    stage<int, int> square_stage = erase<int>(map(square));
+    auto p = make_pipeline<std::string, 8>()
+               .then(parse_stage)
+               .then(filter_stage)
+               .then(square_stage)
+               .sink([&](int i) { out.push_back(i); });
+    for (auto const& s : numbers(100))
+      p.push(s);
+    p.flush();
+    assert(out == expected(100));
+  }
+
+  // Fused stages around an erased one
+  {
+    std::vector<int> out;
+    stage<int, int> filter_stage = erase<int>(filter(is_even));
+    auto p = make_pipeline<std::string>()
+               .then(map(parse))
+               .then(filter_stage)
+               .then(map(square))
+               .sink([&](int i) { out.push_back(i); });
+    for (auto const& s : numbers(1000))
+      p.push(s);
+    p.flush();
+    assert(out == expected(1000));
+  }
+
+  // A batch where everything is filtered out doesn't reach the sink
+  {
+    int calls = 0;
+    auto p = make_pipeline<int, 4>()
+               .then(erase<int>(filter([](int) { return false; })))
+               .sink([&](int) { ++calls; });
+    for (int i = 0; i != 10; ++i)
+      p.push(i);
+    p.flush();
+    assert(calls == 0);
+  }
+}
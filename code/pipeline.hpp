@@ -0,0 +1,237 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include "functions.hpp"
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// A push-based pipeline of stages, where elements flow in fixed-size batches.
+//
+// Stages whose types are known when the pipeline is built are fused: they
+// are composed statically and run element by element in a single loop, where
+// the compiler can inline them into each other. A pipeline switches to a
+// type-erased call only between stages that are erased (chosen at run time),
+// and only once per batch instead of once per element.
+//
+//    auto p = make_pipeline<std::string>()
+//               .then(map(parse) | filter(is_valid))   // fused
+//               .then(runtime_stage)                   // one call per batch
+//               .sink([&](Record const& r) { ... });   // fused
+//    for (auto& line : lines)
+//      p.push(line);
+//    p.flush();
+
+// A function processing a whole batch of elements
+template <typename T>
+using batch_function = function<void(T const*, std::size_t)>;
+
+// A stage chosen at run time, from In to Out. Given the rest of the pipeline,
+// it returns the function processing its own batches, which is expected to
+// forward its results to the rest of the pipeline once per batch.
+template <typename In, typename Out>
+using stage = function<batch_function<In>(batch_function<Out>)>;
+
+
+// sample(pipeline-stages)
+template <typename F>
+struct map_stage {
+  F f;
+
+  template <typename X>
+  using output = std::decay_t<std::invoke_result_t<F const&, X const&>>;
+
+  template <typename X, typename Emit>
+  void operator()(X const& x, Emit& emit) const { emit(f(x)); }
+};
+
+template <typename F>
+struct filter_stage {
+  F f;
+
+  template <typename X>
+  using output = X;
+
+  template <typename X, typename Emit>
+  void operator()(X const& x, Emit& emit) const { if (f(x)) emit(x); }
+};
+
+// Stages composed statically, to be run one after the other on each element
+template <typename ...Stages>
+struct chain {
+  std::tuple<Stages...> stages;
+};
+
+template <typename F>
+chain<map_stage<F>> map(F f) { return {std::make_tuple(map_stage<F>{std::move(f)})}; }
+
+template <typename F>
+chain<filter_stage<F>> filter(F f) { return {std::make_tuple(filter_stage<F>{std::move(f)})}; }
+
+template <typename ...A, typename ...B>
+chain<A..., B...> operator|(chain<A...> a, chain<B...> b)
+{ return {std::tuple_cat(std::move(a.stages), std::move(b.stages))}; }
+// end-sample
+
+namespace detail {
+  template <typename Chain, typename X>
+  struct chain_output { using type = X; };
+
+  template <typename Stage, typename ...Rest, typename X>
+  struct chain_output<chain<Stage, Rest...>, X>
+    : chain_output<chain<Rest...>, typename Stage::template output<X>>
+  { };
+
+  // Runs stages I... of `stages` on `x`, and passes whatever comes out of the
+  // last one to `emit`.
+  template <std::size_t I, typename Tuple, typename X, typename Emit>
+  void run_stages(Tuple const& stages, X const& x, Emit& emit) {
+    if constexpr (I == std::tuple_size<Tuple>::value) {
+      emit(x);
+    } else {
+      auto next = [&](auto const& y) { run_stages<I + 1>(stages, y, emit); };
+      std::get<I>(stages)(x, next);
+    }
+  }
+
+  // Runs fused stages over a batch, and forwards the results to the next
+  // batch function in one call.
+  template <typename In, typename Chain>
+  class fused_segment {
+    using Out = typename chain_output<Chain, In>::type;
+    Chain chain_;
+    batch_function<Out> next_;
+    mutable std::vector<Out> out_;
+
+  public:
+    fused_segment(Chain chain, batch_function<Out> next)
+      : chain_{std::move(chain)}, next_{std::move(next)}
+    { }
+
+    void operator()(In const* in, std::size_t n) const {
+      out_.clear();
+      auto emit = [this](Out const& y) { out_.push_back(y); };
+      for (std::size_t i = 0; i != n; ++i)
+        run_stages<0>(chain_.stages, in[i], emit);
+      if (!out_.empty())
+        next_(out_.data(), out_.size());
+    }
+  };
+
+  // Runs fused stages over a batch, and passes their results to the sink.
+  template <typename In, typename Chain, typename Sink>
+  class sink_segment {
+    Chain chain_;
+    Sink sink_;
+
+  public:
+    sink_segment(Chain chain, Sink sink)
+      : chain_{std::move(chain)}, sink_{std::move(sink)}
+    { }
+
+    void operator()(In const* in, std::size_t n) const {
+      auto emit = [this](auto const& y) { sink_(y); };
+      for (std::size_t i = 0; i != n; ++i)
+        run_stages<0>(chain_.stages, in[i], emit);
+    }
+  };
+}
+
+// Turns statically known stages into a stage that can be chosen at run time.
+template <typename In, typename ...Stages>
+stage<In, typename detail::chain_output<chain<Stages...>, In>::type>
+erase(chain<Stages...> c) {
+  using Out = typename detail::chain_output<chain<Stages...>, In>::type;
+  return [c](batch_function<Out> next) -> batch_function<In> {
+    return detail::fused_segment<In, chain<Stages...>>{c, std::move(next)};
+  };
+}
+
+
+// sample(pipeline)
+template <typename In, std::size_t BatchSize = 256>
+class pipeline {
+  batch_function<In> head_;
+  std::vector<In> batch_;
+
+public:
+  explicit pipeline(batch_function<In> head) : head_{std::move(head)}
+  { batch_.reserve(BatchSize); }
+
+  void push(In x) {
+    batch_.push_back(std::move(x));
+    if (batch_.size() == BatchSize)
+      flush();
+  }
+
+  // Sends the elements pushed so far through the pipeline, without waiting
+  // for the batch to be full. This must be called after the last push.
+  void flush() {
+    if (!batch_.empty()) {
+      head_(batch_.data(), batch_.size());
+      batch_.clear();
+    }
+  }
+};
+// end-sample
+
+// Builds a pipeline from its first stage to its sink. `Build` turns a batch
+// function taking `Mid` into the function at the head of the pipeline, and
+// `Pending` holds the stages from `Mid` to `Out` that are not erased yet.
+template <typename In, std::size_t BatchSize, typename Mid, typename Build,
+          typename Pending>
+class pipeline_builder {
+  using Out = typename detail::chain_output<Pending, Mid>::type;
+  Build build_;
+  Pending pending_;
+
+public:
+  pipeline_builder(Build build, Pending pending)
+    : build_{std::move(build)}, pending_{std::move(pending)}
+  { }
+
+  // Appends statically known stages, which are fused with the previous ones.
+  template <typename ...Stages>
+  auto then(chain<Stages...> stages) && {
+    auto fused = std::move(pending_) | std::move(stages);
+    return pipeline_builder<In, BatchSize, Mid, Build, decltype(fused)>{
+      std::move(build_), std::move(fused)};
+  }
+
+  // Appends an erased stage, which is called once per batch.
+  template <typename Next>
+  auto then(stage<Out, Next> s) && {
+    auto build = [build = std::move(build_), pending = std::move(pending_),
+                  s = std::move(s)](batch_function<Next> next) {
+      if constexpr (std::is_same<Pending, chain<>>::value)
+        return build(s(std::move(next)));
+      else
+        return build(detail::fused_segment<Mid, Pending>{pending, s(std::move(next))});
+    };
+    return pipeline_builder<In, BatchSize, Next, decltype(build), chain<>>{
+      std::move(build), chain<>{}};
+  }
+
+  // Ends the pipeline with `sink`, which is called on every element that
+  // makes it through, fused with the pending stages.
+  template <typename Sink>
+  pipeline<In, BatchSize> sink(Sink sink) && {
+    return pipeline<In, BatchSize>{build_(
+      detail::sink_segment<Mid, Pending, Sink>{std::move(pending_), std::move(sink)})};
+  }
+};
+
+template <typename In, std::size_t BatchSize = 256>
+auto make_pipeline() {
+  auto build = [](batch_function<In> head) { return head; };
+  return pipeline_builder<In, BatchSize, In, decltype(build), chain<>>{build, chain<>{}};
+}
+
+#endif // header guard
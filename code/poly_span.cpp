@@ -0,0 +1,189 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#include "vtable.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+// A VehicleRef per element costs a vtable pointer and an object pointer, and
+// passing a std::vector<Car> to code expecting Vehicles means building a
+// whole vector of them. When all the elements have the same type, a single
+// vtable is enough: VehicleSpan stores it once, along with a base pointer, a
+// stride and a count, so it is built in O(1) from any contiguous array.
+
+class VehicleRef {
+  vtable const* const vptr_;
+  void* ref_;
+
+public:
+  template <typename Any>
+  VehicleRef(Any& vehicle)
+    : vptr_{&vtable_for<Any>}
+    , ref_{&vehicle}
+  { }
+
+  VehicleRef(vtable const* vptr, void* ref)
+    : vptr_{vptr}
+    , ref_{ref}
+  { }
+
+  void accelerate()
+  { vptr_->accelerate(ref_); }
+};
+
+// Batch entry points, which loop inside the typed function so that the
+// method can be inlined, and the span pays one indirect call per batch.
+struct span_vtable {
+  vtable const* const element;
+  void (*accelerate_n)(char* first, std::ptrdiff_t stride, std::size_t n);
+};
+
+template <typename T>
+inline constexpr span_vtable span_vtable_for = {
+  &vtable_for<T>,
+  [](char* first, std::ptrdiff_t stride, std::size_t n) {
+    for (; n != 0; --n, first += stride)
+      reinterpret_cast<T*>(first)->accelerate();
+  }
+};
+
+class VehicleSpan {
+  span_vtable const* vptr_;
+  char* first_;
+  std::ptrdiff_t stride_;
+  std::size_t size_;
+
+public:
+  // `size` objects of type Any, each `stride` bytes after the previous one
+  template <typename Any>
+  VehicleSpan(Any* first, std::size_t size, std::ptrdiff_t stride = sizeof(Any))
+    : vptr_{&span_vtable_for<Any>}
+    , first_{reinterpret_cast<char*>(first)}
+    , stride_{stride}
+    , size_{size}
+  { }
+
+  // The `member` of each of the `size` objects starting at `first`
+  template <typename Object, typename Any>
+  VehicleSpan(Object* first, std::size_t size, Any Object::* member)
+    : VehicleSpan{&(first->*member), size, sizeof(Object)}
+  { }
+
+  // Any contiguous range, like std::vector<Car> or Car[N]
+  template <typename Range, typename = decltype(std::data(std::declval<Range&>()))>
+  VehicleSpan(Range& range)
+    : VehicleSpan{std::data(range), std::size(range)}
+  { }
+
+  class iterator {
+    friend class VehicleSpan;
+    vtable const* vptr_;
+    char* current_;
+    std::ptrdiff_t stride_;
+
+    iterator(vtable const* vptr, char* current, std::ptrdiff_t stride)
+      : vptr_{vptr}, current_{current}, stride_{stride}
+    { }
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = VehicleRef;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = VehicleRef;
+
+    VehicleRef operator*() const
+    { return VehicleRef{vptr_, current_}; }
+
+    iterator& operator++()
+    { current_ += stride_; return *this; }
+
+    iterator operator++(int)
+    { iterator it = *this; ++*this; return it; }
+
+    friend bool operator==(iterator const& a, iterator const& b)
+    { return a.current_ == b.current_; }
+
+    friend bool operator!=(iterator const& a, iterator const& b)
+    { return !(a == b); }
+  };
+
+  iterator begin() const
+  { return iterator{vptr_->element, first_, stride_}; }
+
+  iterator end() const
+  { return iterator{vptr_->element, first_ + stride_ * static_cast<std::ptrdiff_t>(size_), stride_}; }
+
+  VehicleRef operator[](std::size_t i) const
+  { return VehicleRef{vptr_->element, first_ + stride_ * static_cast<std::ptrdiff_t>(i)}; }
+
+  std::size_t size() const
+  { return size_; }
+
+  // Calls accelerate() on every element, with a single indirect call
+  void accelerate()
+  { vptr_->accelerate_n(first_, stride_, size_); }
+
+  template <typename T>
+  bool is() const
+  { return vptr_ == &span_vtable_for<T>; }
+};
+
+
+//////////////////////////////////////////////////////////////////////////////
+struct Car {
+  std::string make;
+  int year;
+  int speed = 0;
+  void accelerate() { ++speed; }
+};
+
+struct Truck {
+  std::string make;
+  int year;
+  int speed = 0;
+  void accelerate() { std::cout << "Truck::accelerate()" << std::endl; }
+};
+
+// Takes any fleet of vehicles, whatever their type
+void accelerate_all(VehicleSpan fleet) {
+  fleet.accelerate();
+}
+
+struct Parking {
+  int spot;
+  Car car;
+};
+
+int main() {
+  std::vector<Car> cars{{"Audi", 2017}, {"Ford", 2009}, {"Toyota", 2014}};
+  accelerate_all(cars);
+  for (Car const& car : cars)
+    assert(car.speed == 1);
+
+  // Iterating yields references to the elements, built on the fly
+  VehicleSpan span{cars};
+  assert(span.size() == 3);
+  for (VehicleRef vehicle : span)
+    vehicle.accelerate();
+  span[1].accelerate();
+  assert(cars[0].speed == 2 && cars[1].speed == 3 && cars[2].speed == 2);
+
+  // A span over a member of each element uses the element's size as stride
+  Parking parking[] = {{1, {"Audi", 2017}}, {2, {"Ford", 2009}}};
+  VehicleSpan parked{parking, 2, &Parking::car};
+  parked.accelerate();
+  assert(parking[0].car.speed == 1 && parking[1].car.speed == 1);
+  assert(parked.is<Car>() && !parked.is<Truck>());
+
+  Truck trucks[] = {{"Chevrolet", 2015}};
+  accelerate_all(trucks);
+  assert(std::distance(VehicleSpan{trucks}.begin(), VehicleSpan{trucks}.end()) == 1);
+}
@@ -1,43 +1,18 @@
 // Copyright Louis Dionne 2018
 // Distributed under the Boost Software License, Version 1.0.
 
-#include "vtable.hpp"
+#include "remote_storage.hpp"
 
+#include <cassert>
 #include <cstddef>
 #include <cstdlib>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
+using remote_storage::Vehicle;
 
 
-// sample(Vehicle)
-class Vehicle {
-  vtable const* const vptr_;
-  void* ptr_;
-
-public:
-  template <typename Any>
-    // enabled only when vehicle.accelerate() is valid
-  Vehicle(Any vehicle)
-    : vptr_{&vtable_for<Any>}
-    , ptr_{new Any(vehicle)}
-  { }
-
-  Vehicle(Vehicle const& other); // implementation omitted
-
-  void accelerate()
-  { vptr_->accelerate(ptr_); }
-
-  ~Vehicle()
-  { vptr_->delete_(ptr_); }
-};
-// end-sample
-
-Vehicle::Vehicle(Vehicle const& other)
-  : vptr_{other.vptr_}
-  , ptr_{other.vptr_->clone(other.ptr_)}
-{ }
-
 //////////////////////////////////////////////////////////////////////////////
 struct Car {
   std::string make;
@@ -68,5 +43,12 @@ int main() {
   for (auto& vehicle : vehicles) {
     vehicle.accelerate();
   }
+
+  assert(vehicles[0].is<Car>() && !vehicles[0].is<Truck>());
+  assert(vehicles[1].try_as<Truck>()->make == "Chevrolet");
+  assert(vehicles[2].try_as<Car>() == nullptr);
+
+  Vehicle ford{std::in_place_type<Truck>, "Ford", 2009};          // skip-sample
+  assert(ford.try_as<Truck>()->year == 2009);                     // skip-sample
 }
 // end-sample
@@ -0,0 +1,60 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#ifndef REMOTE_STORAGE_HPP
+#define REMOTE_STORAGE_HPP
+
+#include "vtable.hpp"
+
+#include <utility>
+
+
+namespace remote_storage {
+// sample(Vehicle)
+class Vehicle {
+  vtable const* const vptr_;
+  void* ptr_;
+
+public:
+  template <typename Any>
+    // enabled only when vehicle.accelerate() is valid
+  Vehicle(Any vehicle)
+    : vptr_{&vtable_for<Any>}
+    , ptr_{new Any(std::move(vehicle))}
+  { }
+                                                      // skip-sample
+  template <typename Any, typename ...Args>           // skip-sample
+  Vehicle(std::in_place_type_t<Any>, Args&& ...args)  // skip-sample
+    : vptr_{&vtable_for<Any>}                         // skip-sample
+    , ptr_{new Any{std::forward<Args>(args)...}}      // skip-sample
+  { }                                                 // skip-sample
+
+  Vehicle(Vehicle const& other); // implementation omitted
+
+  void accelerate()
+  { vptr_->accelerate(ptr_); }
+                                                               // skip-sample
+  template <typename T>                                        // skip-sample
+  bool is() const                                              // skip-sample
+  { return vptr_ == &vtable_for<T>; }                          // skip-sample
+                                                               // skip-sample
+  template <typename T>                                        // skip-sample
+  T* try_as()                                                  // skip-sample
+  { return is<T>() ? static_cast<T*>(ptr_) : nullptr; }        // skip-sample
+                                                               // skip-sample
+  template <typename T>                                        // skip-sample
+  T const* try_as() const                                      // skip-sample
+  { return is<T>() ? static_cast<T const*>(ptr_) : nullptr; }  // skip-sample
+
+  ~Vehicle()
+  { vptr_->delete_(ptr_); }
+};
+// end-sample
+
+inline Vehicle::Vehicle(Vehicle const& other)
+  : vptr_{other.vptr_}
+  , ptr_{other.vptr_->clone(other.ptr_)}
+{ }
+} // end namespace remote_storage
+
+#endif // header guard
@@ -1,56 +1,16 @@
 // Copyright Louis Dionne 2018
 // Distributed under the Boost Software License, Version 1.0.
 
-#include "vtable.hpp"
+#include "sbo_storage.hpp"
 
+#include <cassert>
 #include <cstddef>
 #include <cstdlib>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
-
-
-// sample(Vehicle)
-struct Vehicle {
-  vtable const* const vptr_;
-  union { void* ptr_;
-          std::aligned_storage_t<16> buffer_; };
-  bool on_heap_;
-
-  template <typename Any>
-  Vehicle(Any vehicle) : vptr_{&vtable_for<Any>} {
-    if constexpr (sizeof(Any) > 16) {
-      on_heap_ = true;
-      ptr_ = new Any(vehicle);
-    } else {
-      on_heap_ = false;
-      new (&buffer_) Any{vehicle};
-    }
-  }
-
-  void accelerate()
-  { vptr_->accelerate(on_heap_ ? ptr_ : &buffer_); }
-// end-sample
-
-  Vehicle(Vehicle const& other) : vptr_{other.vptr_} {
-    if (other.on_heap_) {
-      ptr_ = other.vptr_->clone(other.ptr_);
-    } else {
-      other.vptr_->copy(&buffer_, &other.buffer_);
-    }
-  }
-
-  ~Vehicle() {
-    if (on_heap_) {
-      vptr_->delete_(ptr_);
-    } else {
-      vptr_->dtor(&buffer_);
-    }
-  }
-// sample(Vehicle)
-};
-// end-sample
-
+using Vehicle = sbo_storage::Vehicle<16>;
 
 
 //////////////////////////////////////////////////////////////////////////////
@@ -72,6 +32,16 @@ struct Plane {
   void accelerate() { std::cout << "Plane::accelerate()" << std::endl; }
 };
 
+struct Bike {
+  int year;
+  void accelerate() { std::cout << "Bike::accelerate()" << std::endl; }
+};
+
+struct Scooter {
+  int year;
+  void accelerate() { std::cout << "Scooter::accelerate()" << std::endl; }
+};
+
 // sample(main)
 int main() {
   std::vector<Vehicle> vehicles;
@@ -83,5 +53,38 @@ int main() {
   for (auto& vehicle : vehicles) {
     vehicle.accelerate();
   }
+
+  assert(vehicles[0].is<Car>() && !vehicles[0].is<Truck>());
+  assert(vehicles[1].try_as<Truck>()->make == "Chevrolet");
+  assert(vehicles[2].try_as<Car>() == nullptr);
+
+  // Assignment between Vehicles holding the same type reuses the object
+  Vehicle audi = Car{"Audi", 2017}, ford = Car{"Ford", 2009};
+  Car const* car = audi.try_as<Car>();
+  audi = ford;
+  assert(audi.try_as<Car>() == car && car->make == "Ford");
+  audi = vehicles[1];
+  assert(audi.try_as<Truck>()->make == "Chevrolet");
+
+  // Swap, for every combination of inline (Bike) and heap-allocated objects
+  Vehicle bike = Bike{2018}, scooter = Scooter{2016}, plane = Plane{"Boeing", "747"};
+  swap(bike, scooter);
+  assert(bike.try_as<Scooter>()->year == 2016 && scooter.try_as<Bike>()->year == 2018);
+  swap(bike, plane);
+  assert(bike.try_as<Plane>()->make == "Boeing" && plane.try_as<Scooter>()->year == 2016);
+  swap(bike, audi);
+  assert(bike.try_as<Truck>() && audi.try_as<Plane>());
+  swap(scooter, plane);
+  assert(scooter.try_as<Scooter>() && plane.try_as<Bike>());
+  Vehicle old_bike = Bike{1990};
+  swap(plane, old_bike);
+  assert(plane.try_as<Bike>()->year == 1990 && old_bike.try_as<Bike>()->year == 2018);
+  plane = std::move(old_bike);
+  assert(plane.try_as<Bike>()->year == 2018);
+
+  Vehicle f150{std::in_place_type<Truck>, "Ford", 2009};          // skip-sample
+  Vehicle bmx{std::in_place_type<Bike>, 2001};                    // skip-sample
+  assert(f150.try_as<Truck>()->year == 2009);                     // skip-sample
+  assert(bmx.try_as<Bike>()->year == 2001);                       // skip-sample
 }
 // end-sample
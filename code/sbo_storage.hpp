@@ -0,0 +1,183 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#ifndef SBO_STORAGE_HPP
+#define SBO_STORAGE_HPP
+
+#include "vtable.hpp"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace sbo_storage {
+// sample(Vehicle)
+template <std::size_t Size>
+struct Vehicle {
+  vtable const* vptr_;
+  union { void* ptr_;
+          std::aligned_storage_t<Size> buffer_; };
+  bool on_heap_;
+
+  template <typename Any>
+  Vehicle(Any vehicle) : vptr_{&vtable_for<Any>} {
+    if constexpr (sizeof(Any) > Size) {
+      on_heap_ = true;
+      ptr_ = new Any(std::move(vehicle));
+    } else {
+      on_heap_ = false;
+      new (&buffer_) Any{std::move(vehicle)};
+    }
+  }
+
+  void accelerate()
+  { vptr_->accelerate(on_heap_ ? ptr_ : &buffer_); }
+// end-sample
+
+  template <typename Any, typename ...Args>
+  Vehicle(std::in_place_type_t<Any>, Args&& ...args) : vptr_{&vtable_for<Any>} {
+    if constexpr (sizeof(Any) > Size) {
+      on_heap_ = true;
+      ptr_ = new Any{std::forward<Args>(args)...};
+    } else {
+      on_heap_ = false;
+      new (&buffer_) Any{std::forward<Args>(args)...};
+    }
+  }
+
+  Vehicle(Vehicle const& other) : vptr_{other.vptr_}, on_heap_{other.on_heap_} {
+    if (other.on_heap_) {
+      ptr_ = other.vptr_->clone(other.ptr_);
+    } else {
+      other.vptr_->copy(&buffer_, &other.buffer_);
+    }
+  }
+
+  // A moved-from Vehicle can only be assigned to or destroyed.
+  Vehicle(Vehicle&& other) noexcept : vptr_{other.vptr_}, on_heap_{other.on_heap_} {
+    if (other.on_heap_) {
+      ptr_ = std::exchange(other.ptr_, nullptr);
+    } else {
+      other.vptr_->move(&buffer_, &other.buffer_);
+    }
+  }
+
+  // When both Vehicles hold the same type, assignment uses that type's own
+  // assignment operator in place instead of destroying and reconstructing.
+  Vehicle& operator=(Vehicle const& other) {
+    if (vptr_ == other.vptr_ && storage() != nullptr) {
+      vptr_->copy_assign(storage(), other.storage());
+    } else {
+      Vehicle copy{other};
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+
+  Vehicle& operator=(Vehicle&& other) noexcept {
+    if (this == &other) {
+      return *this;
+    }
+    if (on_heap_ && other.on_heap_) {
+      // Our old object will be destroyed along with `other`
+      std::swap(vptr_, other.vptr_);
+      std::swap(ptr_, other.ptr_);
+    } else if (vptr_ == other.vptr_) {
+      vptr_->move_assign(&buffer_, &other.buffer_);
+    } else {
+      reset();
+      vptr_ = other.vptr_;
+      on_heap_ = other.on_heap_;
+      if (other.on_heap_) {
+        ptr_ = std::exchange(other.ptr_, nullptr);
+      } else {
+        other.vptr_->move(&buffer_, &other.buffer_);
+      }
+    }
+    return *this;
+  }
+
+  // Handles the four inline/heap combinations without allocating: heap
+  // objects are swapped by pointer, and inline objects of different types go
+  // through a buffer on the stack.
+  friend void swap(Vehicle& a, Vehicle& b) noexcept {
+    if (&a == &b) {
+      return;
+    }
+    if (a.on_heap_ && b.on_heap_) {
+      std::swap(a.vptr_, b.vptr_);
+      std::swap(a.ptr_, b.ptr_);
+    } else if (a.vptr_ == b.vptr_) {
+      a.vptr_->swap(&a.buffer_, &b.buffer_);
+    } else if (a.on_heap_ != b.on_heap_) {
+      Vehicle& local = a.on_heap_ ? b : a;
+      Vehicle& remote = a.on_heap_ ? a : b;
+      void* ptr = remote.ptr_;
+      local.vptr_->move(&remote.buffer_, &local.buffer_);
+      local.vptr_->dtor(&local.buffer_);
+      local.ptr_ = ptr;
+      std::swap(a.vptr_, b.vptr_);
+      std::swap(a.on_heap_, b.on_heap_);
+    } else {
+      decltype(a.buffer_) tmp;
+      a.vptr_->move(&tmp, &a.buffer_);
+      a.vptr_->dtor(&a.buffer_);
+      b.vptr_->move(&a.buffer_, &b.buffer_);
+      b.vptr_->dtor(&b.buffer_);
+      a.vptr_->move(&b.buffer_, &tmp);
+      a.vptr_->dtor(&tmp);
+      std::swap(a.vptr_, b.vptr_);
+    }
+  }
+
+  void* storage()
+  { return on_heap_ ? ptr_ : &buffer_; }
+
+  void const* storage() const
+  { return on_heap_ ? ptr_ : &buffer_; }
+
+  vtable const* vptr() const
+  { return vptr_; }
+
+  bool on_heap() const
+  { return on_heap_; }
+
+  // Gives up the held object, which the caller must destroy; destroying the
+  // Vehicle then does nothing (see bulk_destroy.hpp).
+  void release()
+  { vptr_ = nullptr; }
+
+  // Destroys the held object; the members must be reassigned before use
+  void reset() {
+    if (on_heap_) {
+      vptr_->delete_(ptr_);
+    } else {
+      vptr_->dtor(&buffer_);
+    }
+  }
+
+  template <typename T>
+  bool is() const
+  { return vptr_ == &vtable_for<T>; }
+
+  template <typename T>
+  T* try_as()
+  { return is<T>() ? static_cast<T*>(on_heap_ ? ptr_ : &buffer_) : nullptr; }
+
+  template <typename T>
+  T const* try_as() const
+  { return is<T>() ? static_cast<T const*>(on_heap_ ? ptr_ : &buffer_) : nullptr; }
+
+  ~Vehicle() {
+    if (vptr_ != nullptr) {
+      reset();
+    }
+  }
+// sample(Vehicle)
+};
+// end-sample
+} // end namespace sbo_storage
+
+#endif // header guard
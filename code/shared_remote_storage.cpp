@@ -1,33 +1,18 @@
 // Copyright Louis Dionne 2018
 // Distributed under the Boost Software License, Version 1.0.
 
-#include "vtable.hpp"
+#include "shared_remote_storage.hpp"
 
+#include <cassert>
 #include <cstddef>
 #include <cstdlib>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
-
-
-// sample(Vehicle)
-class Vehicle {
-  vtable const* const vptr_;
-  std::shared_ptr<void> ptr_;
-
-public:
-  template <typename Any>
-  Vehicle(Any vehicle)
-    : vptr_{&vtable_for<Any>}
-    , ptr_{std::make_shared<Any>(vehicle)}
-  { }
-
-  void accelerate()
-  { vptr_->accelerate(ptr_.get()); }
-};
-// end-sample
-
+using shared_remote_storage::Vehicle;
 
 
 //////////////////////////////////////////////////////////////////////////////
@@ -60,5 +45,12 @@ int main() {
   for (auto& vehicle : vehicles) {
     vehicle.accelerate();
   }
+
+  assert(vehicles[0].is<Car>() && !vehicles[0].is<Truck>());
+  assert(vehicles[1].try_as<Truck>()->make == "Chevrolet");
+  assert(vehicles[2].try_as<Car>() == nullptr);
+
+  Vehicle ford{std::in_place_type<Truck>, "Ford", 2009};          // skip-sample
+  assert(ford.try_as<Truck>()->year == 2009);                     // skip-sample
 }
 // end-sample
@@ -0,0 +1,57 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#ifndef SHARED_REMOTE_STORAGE_HPP
+#define SHARED_REMOTE_STORAGE_HPP
+
+#include "vtable.hpp"
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+
+namespace shared_remote_storage {
+// sample(Vehicle)
+class Vehicle {
+  vtable const* const vptr_;
+  std::shared_ptr<void> ptr_;
+
+public:
+  template <typename Any>
+  Vehicle(Any vehicle)
+    : vptr_{&vtable_for<Any>}
+    , ptr_{std::make_shared<Any>(std::move(vehicle))}
+  { }
+                                                                          // skip-sample
+  // make_shared can only use parentheses, which can't                    // skip-sample
+  // initialize an aggregate like Car before C++20.                       // skip-sample
+  template <typename Any, typename ...Args>                               // skip-sample
+  Vehicle(std::in_place_type_t<Any>, Args&& ...args)                      // skip-sample
+    : vptr_{&vtable_for<Any>}                                             // skip-sample
+  {                                                                       // skip-sample
+    if constexpr (std::is_constructible<Any, Args...>::value)             // skip-sample
+      ptr_ = std::make_shared<Any>(std::forward<Args>(args)...);          // skip-sample
+    else                                                                  // skip-sample
+      ptr_ = std::shared_ptr<Any>(new Any{std::forward<Args>(args)...});  // skip-sample
+  }                                                                       // skip-sample
+
+  void accelerate()
+  { vptr_->accelerate(ptr_.get()); }
+                                                                     // skip-sample
+  template <typename T>                                              // skip-sample
+  bool is() const                                                    // skip-sample
+  { return vptr_ == &vtable_for<T>; }                                // skip-sample
+                                                                     // skip-sample
+  template <typename T>                                              // skip-sample
+  T* try_as()                                                        // skip-sample
+  { return is<T>() ? static_cast<T*>(ptr_.get()) : nullptr; }        // skip-sample
+                                                                     // skip-sample
+  template <typename T>                                              // skip-sample
+  T const* try_as() const                                            // skip-sample
+  { return is<T>() ? static_cast<T const*>(ptr_.get()) : nullptr; }  // skip-sample
+};
+// end-sample
+} // end namespace shared_remote_storage
+
+#endif // header guard
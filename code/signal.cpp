@@ -0,0 +1,125 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#include "signal.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+int main() {
+  // Every connected slot is called, until it is disconnected
+  {
+    signal<void(int)> changed;
+    int a = 0, b = 0;
+    auto ca = changed.connect([&](int x) { a += x; });
+    auto cb = changed.connect([&](int x) { b += x; });
+    changed(1);
+    assert(a == 1 && b == 1);
+
+    ca.disconnect();
+    assert(!ca.connected() && cb.connected());
+    changed(2);
+    assert(a == 1 && b == 3);
+
+    ca.disconnect(); // disconnecting twice does nothing
+    changed(3);
+    assert(a == 1 && b == 6);
+  }
+
+  // Slots are reused after being disconnected, and a stale connection does
+  // not disconnect the slot that took its place
+  {
+    signal<void(int)> changed;
+    int a = 0, b = 0;
+    auto ca = changed.connect([&](int x) { a += x; });
+    auto stale = ca;
+    ca.disconnect();
+    auto cb = changed.connect([&](int x) { b += x; });
+    stale.disconnect();
+    changed(1);
+    assert(a == 0 && b == 1);
+    assert(cb.connected());
+  }
+
+  // Every slot gets its own copy of the arguments, so a slot that moves from
+  // its copy leaves the others untouched
+  {
+    signal<void(std::string)> said;
+    std::vector<std::string> heard;
+    said.connect([&](std::string s) { heard.push_back(std::move(s)); });
+    said.connect([&](std::string s) { heard.push_back(std::move(s)); });
+    said("a string too long for the small string optimization");
+    assert(heard.size() == 2);
+    assert(heard[0] == "a string too long for the small string optimization");
+    assert(heard[1] == heard[0]);
+  }
+
+  // More slots than fit in a single block
+  {
+    signal<void(int)> changed;
+    int calls = 0;
+    std::vector<signal<void(int)>::connection> connections;
+    for (int i = 0; i != 200; ++i)
+      connections.push_back(changed.connect([&](int) { ++calls; }));
+    changed(0);
+    assert(calls == 200);
+
+    for (int i = 0; i != 200; i += 2)
+      connections[i].disconnect();
+    calls = 0;
+    changed(0);
+    assert(calls == 100);
+  }
+
+  // Disconnected slots are destroyed, even when it happens from within a slot
+  {
+    auto token = std::make_shared<int>(0);
+    {
+      signal<void()> fired;
+      signal<void()>::connection self;
+      int calls = 0;
+      self = fired.connect([&calls, &self, token] { ++calls; self.disconnect(); });
+      assert(token.use_count() == 2);
+      fired();
+      fired();
+      assert(calls == 1);
+      assert(token.use_count() == 1);
+    }
+    assert(token.use_count() == 1);
+  }
+
+  // Emitting from several threads while slots come and go
+  {
+    signal<void(int)> changed;
+    std::atomic<int> total{0};
+    auto keep = changed.connect([&](int x) { total += x; });
+
+    std::atomic<bool> done{false};
+    std::vector<std::thread> emitters;
+    for (int t = 0; t != 4; ++t) {
+      emitters.emplace_back([&] {
+        for (int i = 0; i != 1000; ++i)
+          changed(1);
+      });
+    }
+    std::thread churn{[&] {
+      while (!done) {
+        auto tmp = std::make_shared<int>(0);
+        auto c = changed.connect([tmp](int) { ++*tmp; });
+        c.disconnect();
+      }
+    }};
+
+    for (auto& t : emitters)
+      t.join();
+    done = true;
+    churn.join();
+    assert(total == 4000);
+    assert(keep.connected());
+  }
+}
@@ -0,0 +1,218 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#ifndef SIGNAL_HPP
+#define SIGNAL_HPP
+
+#include "atomic_shared_function.hpp"
+#include "functions.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#  include <intrin.h>
+#endif
+
+
+namespace detail {
+  // Index of the lowest bit set in `bits`, which must not be 0.
+  inline unsigned lowest_bit(std::uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(bits));
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<unsigned>(index);
+#else
+    unsigned index = 0;
+    while (!(bits & 1)) { bits >>= 1; ++index; }
+    return index;
+#endif
+  }
+}
+
+template <typename Signature, std::size_t SlotSize = 32>
+class signal;
+
+// A signal calling every connected slot when it is emitted.
+//
+// Slots are inplace_functions, stored contiguously in blocks of 64 that are
+// never moved, so connecting never allocates except to add a block. Each
+// block has a bitmask of its live slots, which emitters read to find the
+// slots to call.
+//
+// Emitting takes no lock and can happen from several threads at once, and
+// concurrently with connect() and disconnect(); it is protected by the same
+// epoch as atomic_shared_function. Connecting and disconnecting are
+// serialized with each other. A disconnected slot is not called by emissions
+// that start afterwards, but it is only destroyed once the emissions that
+// might still be calling it are over. When disconnecting from within a slot
+// (or from within any other epoch-protected call), the destruction is
+// deferred to the next connect, disconnect or emission on another stack.
+//
+// No emission may be in progress when the signal itself is destroyed.
+template <typename ...Args, std::size_t SlotSize>
+class signal<void(Args...), SlotSize> {
+  using slot = inplace_function<void(Args...), SlotSize>;
+  static constexpr std::size_t block_size = 64;
+
+  // Every slot is called with the same arguments, so they can't be moved
+  // into any one of them: each slot gets a copy, or shares a reference.
+  static_assert((!std::is_rvalue_reference<Args>::value && ...) &&
+                (std::is_copy_constructible<std::decay_t<Args>>::value && ...),
+    "the arguments of a signal are passed to every slot, so they must be "
+    "copyable (or lvalue references)");
+
+  struct block {
+    std::atomic<std::uint64_t> live{0};
+    std::uint64_t constructed = 0;
+    std::uint32_t generation[block_size] = {};
+    std::atomic<block*> next{nullptr};
+    std::aligned_storage_t<sizeof(slot), alignof(slot)> slots[block_size];
+
+    slot& at(std::size_t i) { return *reinterpret_cast<slot*>(&slots[i]); }
+  };
+
+  std::atomic<block*> head_{nullptr};
+  block* tail_ = nullptr;
+  std::mutex writer_;
+  std::vector<std::pair<block*, std::size_t>> pending_;
+  std::atomic<bool> has_pending_{false};
+
+  // Destroys the disconnected slots, unless this thread is in the middle of
+  // an emission, which synchronize() would wait for forever. The lock is
+  // released while waiting, so that a slot running on another thread can
+  // still connect or disconnect; the slots being reclaimed are not reused
+  // before they are destroyed.
+  void reclaim(std::unique_lock<std::mutex>& lock) {
+    detail::epoch_domain& domain = detail::epoch_domain::instance();
+    if (pending_.empty() || domain.reading())
+      return;
+    std::vector<std::pair<block*, std::size_t>> reclaimed;
+    reclaimed.swap(pending_);
+    has_pending_.store(false, std::memory_order_relaxed);
+
+    lock.unlock();
+    domain.synchronize();
+    lock.lock();
+
+    for (auto const& p : reclaimed) {
+      p.first->at(p.second).~slot();
+      p.first->constructed &= ~(std::uint64_t{1} << p.second);
+    }
+  }
+
+  void disconnect(block* b, std::size_t i, std::uint32_t generation) {
+    std::unique_lock<std::mutex> lock{writer_};
+    std::uint64_t const bit = std::uint64_t{1} << i;
+    if (b->generation[i] != generation ||
+        !(b->live.load(std::memory_order_relaxed) & bit))
+      return;
+    b->live.fetch_and(~bit, std::memory_order_seq_cst);
+    ++b->generation[i];
+    pending_.emplace_back(b, i);
+    has_pending_.store(true, std::memory_order_relaxed);
+    reclaim(lock);
+  }
+
+public:
+  // A handle to a connected slot, which stays valid whatever happens to the
+  // other slots. Disconnecting twice, or after the slot was disconnected
+  // through another copy of the handle, does nothing.
+  class connection {
+    friend class signal;
+    signal* signal_ = nullptr;
+    block* block_ = nullptr;
+    std::size_t index_ = 0;
+    std::uint32_t generation_ = 0;
+
+    connection(signal* s, block* b, std::size_t i, std::uint32_t g)
+      : signal_{s}, block_{b}, index_{i}, generation_{g}
+    { }
+
+  public:
+    connection() = default;
+
+    void disconnect() {
+      if (signal_)
+        signal_->disconnect(block_, index_, generation_);
+      signal_ = nullptr;
+    }
+
+    bool connected() const {
+      if (!signal_)
+        return false;
+      std::lock_guard<std::mutex> lock{signal_->writer_};
+      return block_->generation[index_] == generation_;
+    }
+  };
+
+  signal() = default;
+  signal(signal const&) = delete;
+  signal& operator=(signal const&) = delete;
+
+  template <typename F>
+  connection connect(F&& f) {
+    std::unique_lock<std::mutex> lock{writer_};
+    reclaim(lock);
+
+    block* b = head_.load(std::memory_order_relaxed);
+    while (b && b->constructed == ~std::uint64_t{0})
+      b = b->next.load(std::memory_order_relaxed);
+    if (!b) {
+      b = new block;
+      if (tail_)
+        tail_->next.store(b, std::memory_order_release);
+      else
+        head_.store(b, std::memory_order_release);
+      tail_ = b;
+    }
+
+    std::size_t const i = detail::lowest_bit(~b->constructed);
+    new (&b->slots[i]) slot(std::forward<F>(f));
+    b->constructed |= std::uint64_t{1} << i;
+    b->live.fetch_or(std::uint64_t{1} << i, std::memory_order_release);
+    return connection{this, b, i, b->generation[i]};
+  }
+
+  void operator()(Args ...args) {
+    {
+      detail::read_guard guard;
+      for (block* b = head_.load(std::memory_order_acquire); b;
+                  b = b->next.load(std::memory_order_acquire)) {
+        std::uint64_t live = b->live.load(std::memory_order_seq_cst);
+        while (live) {
+          b->at(detail::lowest_bit(live))(args...);
+          live &= live - 1;
+        }
+      }
+    }
+
+    if (has_pending_.load(std::memory_order_relaxed) &&
+        !detail::epoch_domain::instance().reading()) {
+      std::unique_lock<std::mutex> lock{writer_};
+      reclaim(lock);
+    }
+  }
+
+  ~signal() {
+    block* b = head_.load();
+    while (b) {
+      for (std::size_t i = 0; i != block_size; ++i)
+        if (b->constructed & (std::uint64_t{1} << i))
+          b->at(i).~slot();
+      block* next = b->next.load();
+      delete b;
+      b = next;
+    }
+  }
+};
+
+#endif // header guard
@@ -0,0 +1,76 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#include "sort_by_key.hpp"
+#include "sort_by_key_vehicle.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <vector>
+using sort_by_key_vehicle::Vehicle;
+
+
+//////////////////////////////////////////////////////////////////////////////
+struct Car {
+  std::string make;
+  int year;
+  void accelerate() { }
+};
+
+struct Truck {
+  std::string make;
+  int year;
+  void accelerate() { }
+};
+
+struct Plane {
+  std::string make;
+  std::string model;
+  int year;
+  void accelerate() { }
+};
+
+int main() {
+  std::vector<Vehicle> vehicles;
+
+  vehicles.push_back(Car{"Audi", 2017});
+  vehicles.push_back(Truck{"Chevrolet", 2015});
+  vehicles.push_back(Plane{"Boeing", "747", 1969});
+  vehicles.push_back(Car{"Tesla", 2015});
+  vehicles.push_back(Plane{"Airbus", "A380", 2005});
+
+  sort_by_key(vehicles, &Vehicle::year);
+
+  assert(vehicles[0].make() == "Boeing");
+  assert(vehicles[1].make() == "Airbus");
+  assert(vehicles[2].make() == "Chevrolet"); // stable
+  assert(vehicles[3].make() == "Tesla");
+  assert(vehicles[4].make() == "Audi");
+
+  // keys that are not integers are compared
+  sort_by_key(vehicles, &Vehicle::make);
+  assert(vehicles[0].make() == "Airbus");
+  assert(vehicles[1].make() == "Audi");
+  assert(vehicles[2].make() == "Boeing");
+  assert(vehicles[3].make() == "Chevrolet");
+  assert(vehicles[4].make() == "Tesla");
+
+  std::size_t recent = partition_by_key(vehicles, &Vehicle::year, [](int year) {
+    return year >= 2010;
+  });
+  assert(recent == 3);
+  assert(vehicles[0].make() == "Audi");
+  assert(vehicles[1].make() == "Chevrolet");
+  assert(vehicles[2].make() == "Tesla");
+  assert(vehicles[3].make() == "Airbus");
+  assert(vehicles[4].make() == "Boeing");
+
+  // negative keys are ordered before positive ones
+  std::vector<Vehicle> bc;
+  bc.push_back(Car{"Chariot", -50});
+  bc.push_back(Car{"Cart", 1200});
+  bc.push_back(Car{"Wheel", -3500});
+  sort_by_key(bc, &Vehicle::year);
+  assert(bc[0].year() == -3500 && bc[1].year() == -50 && bc[2].year() == 1200);
+}
@@ -0,0 +1,122 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#ifndef SORT_BY_KEY_HPP
+#define SORT_BY_KEY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace detail {
+  template <typename Key>
+  using keyed_index = std::pair<Key, std::uint32_t>;
+
+  // Maps an integral key to an unsigned integer with the same ordering.
+  template <typename Key>
+  auto radix_bits(Key key) {
+    using U = std::make_unsigned_t<Key>;
+    U bits = static_cast<U>(key);
+    if (std::is_signed<Key>{})
+      bits ^= U{1} << (std::numeric_limits<U>::digits - 1);
+    return bits;
+  }
+
+  // Stable LSD radix sort of (key, index) pairs, one byte at a time.
+  template <typename Key>
+  void radix_sort(std::vector<keyed_index<Key>>& keys) {
+    std::vector<keyed_index<Key>> buffer(keys.size());
+    for (std::size_t shift = 0; shift != sizeof(Key) * 8; shift += 8) {
+      std::size_t counts[257] = {};
+      for (auto const& k : keys)
+        ++counts[((radix_bits(k.first) >> shift) & 0xff) + 1];
+
+      // skip passes where every key has the same byte
+      if (std::count(counts + 1, counts + 257, keys.size()) == 1)
+        continue;
+
+      for (std::size_t b = 1; b != 257; ++b)
+        counts[b] += counts[b - 1];
+      for (auto const& k : keys)
+        buffer[counts[(radix_bits(k.first) >> shift) & 0xff]++] = k;
+      keys.swap(buffer);
+    }
+  }
+
+  template <typename Key>
+  void sort_keys(std::vector<keyed_index<Key>>& keys) {
+    if constexpr (std::is_integral<Key>{} && !std::is_same<Key, bool>{}) {
+      radix_sort(keys);
+    } else {
+      std::stable_sort(keys.begin(), keys.end(), [](auto const& a, auto const& b) {
+        return a.first < b.first;
+      });
+    }
+  }
+
+  // Calls `key` exactly once per element.
+  template <typename Vehicle, typename KeyOf>
+  auto extract_keys(std::vector<Vehicle> const& vehicles, KeyOf& key) {
+    using Key = std::decay_t<std::invoke_result_t<KeyOf&, Vehicle const&>>;
+    std::vector<keyed_index<Key>> keys;
+    keys.reserve(vehicles.size());
+    for (std::size_t i = 0; i != vehicles.size(); ++i)
+      keys.emplace_back(std::invoke(key, vehicles[i]), static_cast<std::uint32_t>(i));
+    return keys;
+  }
+
+  // Reorders `vehicles` so that position i holds what was at `keys[i].second`.
+  // Each cycle of the permutation is walked once, so every element is moved
+  // exactly once, plus one temporary per cycle.
+  template <typename Vehicle, typename Key>
+  void permute(std::vector<Vehicle>& vehicles, std::vector<keyed_index<Key>>& keys) {
+    for (std::uint32_t i = 0; i != keys.size(); ++i) {
+      if (keys[i].second == i)
+        continue;
+      Vehicle tmp{std::move(vehicles[i])};
+      std::uint32_t j = i;
+      while (keys[j].second != i) {
+        std::uint32_t next = keys[j].second;
+        vehicles[j] = std::move(vehicles[next]);
+        keys[j].second = j;
+        j = next;
+      }
+      vehicles[j] = std::move(tmp);
+      keys[j].second = j;
+    }
+  }
+}
+
+// Stably sorts `vehicles` by `std::invoke(key, vehicle)`. Keys are extracted
+// into a flat array up front, with a single dispatch per element, instead of
+// going through the vtable twice per comparison. Integral keys are radix
+// sorted. The handles themselves are then moved into place, which only
+// relocates them and never copies the erased objects.
+template <typename Vehicle, typename KeyOf>
+void sort_by_key(std::vector<Vehicle>& vehicles, KeyOf key) {
+  auto keys = detail::extract_keys(vehicles, key);
+  detail::sort_keys(keys);
+  detail::permute(vehicles, keys);
+}
+
+// Stably partitions `vehicles` so that those for which `pred(key(vehicle))`
+// holds come first, and returns the index of the first one for which it
+// doesn't. Like `sort_by_key`, `key` is called once per element.
+template <typename Vehicle, typename KeyOf, typename Predicate>
+std::size_t partition_by_key(std::vector<Vehicle>& vehicles, KeyOf key, Predicate pred) {
+  auto keys = detail::extract_keys(vehicles, key);
+  auto middle = std::stable_partition(keys.begin(), keys.end(), [&](auto const& k) {
+    return pred(k.first);
+  });
+  std::size_t const result = middle - keys.begin();
+  detail::permute(vehicles, keys);
+  return result;
+}
+
+#endif // header guard
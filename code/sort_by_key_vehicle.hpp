@@ -0,0 +1,89 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+#ifndef SORT_BY_KEY_VEHICLE_HPP
+#define SORT_BY_KEY_VEHICLE_HPP
+
+#include <string>
+#include <utility>
+
+
+namespace sort_by_key_vehicle {
+// sample(vtable)
+struct vtable {
+  void (*accelerate)(void* this_);
+  int (*year)(void const* this_);
+  std::string (*make)(void const* this_);
+  void* (*clone)(void const* this_);   // skip-sample
+  void (*delete_)(void* this_);
+};
+
+template <typename T>
+inline constexpr vtable vtable_for = {
+  [](void* this_) {
+    static_cast<T*>(this_)->accelerate();
+  },
+
+  [](void const* this_) {
+    return static_cast<T const*>(this_)->year;
+  },
+
+  [](void const* this_) {
+    return static_cast<T const*>(this_)->make;
+  },
+                                                  // skip-sample
+  [](void const* this_) -> void* {                // skip-sample
+    return new T(*static_cast<T const*>(this_));  // skip-sample
+  },                                              // skip-sample
+
+  [](void* this_) {
+    delete static_cast<T*>(this_);
+  }
+};
+// end-sample
+
+// sample(Vehicle)
+class Vehicle {
+  vtable const* vptr_;
+  void* ptr_;
+
+public:
+  template <typename Any>
+  Vehicle(Any vehicle)
+    : vptr_{&vtable_for<Any>}
+    , ptr_{new Any(std::move(vehicle))}
+  { }
+
+  Vehicle(Vehicle const& other)                       // skip-sample
+    : vptr_{other.vptr_}                              // skip-sample
+    , ptr_{other.vptr_->clone(other.ptr_)}            // skip-sample
+  { }                                                 // skip-sample
+                                                      // skip-sample
+  // Moving a Vehicle only relocates the handle
+  Vehicle(Vehicle&& other)
+    : vptr_{other.vptr_}
+    , ptr_{std::exchange(other.ptr_, nullptr)}
+  { }
+
+  Vehicle& operator=(Vehicle&& other) {
+    std::swap(vptr_, other.vptr_);
+    std::swap(ptr_, other.ptr_);
+    return *this;
+  }
+
+  void accelerate()
+  { vptr_->accelerate(ptr_); }
+
+  int year() const
+  { return vptr_->year(ptr_); }
+
+  std::string make() const
+  { return vptr_->make(ptr_); }
+
+  ~Vehicle()
+  { if (ptr_) vptr_->delete_(ptr_); }
+};
+// end-sample
+} // end namespace sort_by_key_vehicle
+
+#endif // header guard
@@ -8,16 +8,25 @@
 using namespace dyno::literals;
 
 
+// One object per type, whose address identifies that type. Dyno doesn't
+// expose the vtable of a poly, so `type_id` stands for its identity.
+template <typename T>
+inline constexpr char vehicle_type_id = 0;
+
 // sample(IVehicle)
 struct IVehicle : decltype(dyno::requires(
   dyno::CopyConstructible{},
   dyno::Destructible{},
   "accelerate"_s = dyno::function<void(dyno::T&)>
+  ,                                                           // skip-sample
+  "type_id"_s = dyno::function<void const* (dyno::T const&)>  // skip-sample
 )) { };
 
 template <typename T>
-auto dyno::default_concept_map<IVehicle, T> = dyno::make_concept_map(
+constexpr auto dyno::default_concept_map<IVehicle, T> = dyno::make_concept_map(
   "accelerate"_s = [](T& vehicle) { vehicle.accelerate(); }
+  ,                                                                          // skip-sample
+  "type_id"_s = [](T const&) -> void const* { return &vehicle_type_id<T>; }  // skip-sample
 );
 // end-sample
 
@@ -5,6 +5,9 @@
 #define VTABLE_HPP
 
 #include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 
 // sample(vtable)
@@ -14,10 +17,16 @@ struct vtable {
   void* (*clone)(void const* this_);        // skip-sample
   void (*copy)(void* p, void const* other); // skip-sample
   void (*dtor)(void* p);                    // skip-sample
+  void (*move)(void* p, void* other);                               // skip-sample
+  void (*copy_assign)(void* this_, void const* other);              // skip-sample
+  void (*move_assign)(void* this_, void* other);                    // skip-sample
+  void (*swap)(void* a, void* b);                                   // skip-sample
+  void (*destroy_n)(void* const* ps, std::size_t n, bool heap);     // skip-sample
+  bool trivially_destructible;                                      // skip-sample
 };
 
 template <typename T>
-vtable const vtable_for = {
+inline constexpr vtable vtable_for = {
   [](void* this_) {
     static_cast<T*>(this_)->accelerate();
   },
@@ -36,7 +45,54 @@ vtable const vtable_for = {
                                                   // skip-sample
   [](void* this_) {                               // skip-sample
     static_cast<T*>(this_)->~T();                 // skip-sample
-  }                                               // skip-sample
+  },                                              // skip-sample
+                                                                    // skip-sample
+  [](void* p, void* other) {                                        // skip-sample
+    new (p) T(std::move(*static_cast<T*>(other)));                  // skip-sample
+  },                                                                // skip-sample
+                                                                    // skip-sample
+  [](void* this_, void const* other) {                              // skip-sample
+    if constexpr (std::is_copy_assignable_v<T>) {                   // skip-sample
+      *static_cast<T*>(this_) = *static_cast<T const*>(other);      // skip-sample
+    } else {                                                        // skip-sample
+      static_cast<T*>(this_)->~T();                                 // skip-sample
+      new (this_) T(*static_cast<T const*>(other));                 // skip-sample
+    }                                                               // skip-sample
+  },                                                                // skip-sample
+                                                                    // skip-sample
+  [](void* this_, void* other) {                                    // skip-sample
+    if constexpr (std::is_move_assignable_v<T>) {                   // skip-sample
+      *static_cast<T*>(this_) = std::move(*static_cast<T*>(other)); // skip-sample
+    } else {                                                        // skip-sample
+      static_cast<T*>(this_)->~T();                                 // skip-sample
+      new (this_) T(std::move(*static_cast<T*>(other)));            // skip-sample
+    }                                                               // skip-sample
+  },                                                                // skip-sample
+                                                                    // skip-sample
+  [](void* a, void* b) {                                            // skip-sample
+    if constexpr (std::is_swappable_v<T>) {                         // skip-sample
+      using std::swap;                                              // skip-sample
+      swap(*static_cast<T*>(a), *static_cast<T*>(b));               // skip-sample
+    } else {                                                        // skip-sample
+      T tmp(std::move(*static_cast<T*>(a)));                        // skip-sample
+      static_cast<T*>(a)->~T();                                     // skip-sample
+      new (a) T(std::move(*static_cast<T*>(b)));                    // skip-sample
+      static_cast<T*>(b)->~T();                                     // skip-sample
+      new (b) T(std::move(tmp));                                    // skip-sample
+    }                                                               // skip-sample
+  },                                                                // skip-sample
+                                                                    // skip-sample
+  [](void* const* ps, std::size_t n, bool heap) {                   // skip-sample
+    if (heap) {                                                     // skip-sample
+      for (std::size_t i = 0; i != n; ++i)                          // skip-sample
+        delete static_cast<T*>(ps[i]);                              // skip-sample
+    } else if constexpr (!std::is_trivially_destructible_v<T>) {    // skip-sample
+      for (std::size_t i = 0; i != n; ++i)                          // skip-sample
+        static_cast<T*>(ps[i])->~T();                               // skip-sample
+    }                                                               // skip-sample
+  },                                                                // skip-sample
+                                                                    // skip-sample
+  std::is_trivially_destructible_v<T>                               // skip-sample
 };
 // end-sample
 
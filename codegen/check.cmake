@@ -0,0 +1,193 @@
+# Copyright Louis Dionne 2018
+# Distributed under the Boost Software License, Version 1.0.
+
+# Checks the code generated for a codegen test against the expectations
+# written in its source file, on x86-64. Expectations look like
+#
+#   // CODEGEN: <function> <metric><op><value>...
+#   // CODEGEN(<compiler id>): <function> <metric><op><value>...
+#
+# where the second form only applies when building with that compiler (GNU,
+# Clang, ...), <op> is `=` or `<=`, and <metric> is one of
+#
+#   instructions   number of instructions, without padding
+#   loads          number of instructions reading memory, other than the stack
+#   indirect       number of indirect jumps and calls
+#   calls          number of calls, direct or not
+#
+# Expectations about the object file as a whole look like
+#
+#   // CODEGEN-OBJECT: <metric><op><value>...
+#
+# where <metric> is one of
+#
+#   dynamic_initializers   number of functions run at startup to initialize
+#                          variables (_GLOBAL__sub_I_*, __cxx_global_var_init*)
+#   guard_variables        number of guards checked on first use of a variable
+#                          that isn't constant-initialized (_ZGV*)
+#
+# Usage:
+#   cmake -DOBJDUMP=<objdump> -DOBJECT=<object file> -DSOURCE=<source file>
+#         -DCOMPILER_ID=<compiler id> -P check.cmake
+
+foreach(var OBJDUMP OBJECT SOURCE COMPILER_ID)
+  if (NOT DEFINED ${var})
+    message(FATAL_ERROR "${var} must be defined")
+  endif()
+endforeach()
+
+execute_process(
+  COMMAND "${OBJDUMP}" -d --no-show-raw-insn -M intel "${OBJECT}"
+  OUTPUT_FILE "${OBJECT}.asm"
+  RESULT_VARIABLE result)
+if (NOT result EQUAL 0)
+  message(FATAL_ERROR "Could not disassemble ${OBJECT}")
+endif()
+file(STRINGS "${OBJECT}.asm" disassembly)
+
+execute_process(
+  COMMAND "${OBJDUMP}" -t "${OBJECT}"
+  OUTPUT_VARIABLE symbol_table
+  RESULT_VARIABLE result)
+if (NOT result EQUAL 0)
+  message(FATAL_ERROR "Could not read the symbols of ${OBJECT}")
+endif()
+string(REPLACE "\n" ";" symbol_table "${symbol_table}")
+
+# Counts the object-level metrics, and sets <metric>_count in the caller.
+function(measure_object)
+  set(dynamic_initializers 0)
+  set(guard_variables 0)
+  foreach(line IN LISTS symbol_table)
+    if (line MATCHES "[ \t](_GLOBAL__sub_I_|__cxx_global_var_init)[^ \t]*$")
+      math(EXPR dynamic_initializers "${dynamic_initializers} + 1")
+    elseif (line MATCHES "[ \t]_ZGV[^ \t]*$")
+      math(EXPR guard_variables "${guard_variables} + 1")
+    endif()
+  endforeach()
+  set(dynamic_initializers_count ${dynamic_initializers} PARENT_SCOPE)
+  set(guard_variables_count ${guard_variables} PARENT_SCOPE)
+endfunction()
+
+# Counts the metrics of `function`, and sets <metric>_count in the caller.
+function(measure function)
+  set(inside FALSE)
+  set(found FALSE)
+  foreach(metric instructions loads indirect calls)
+    set(${metric} 0)
+  endforeach()
+
+  foreach(line IN LISTS disassembly)
+    if (line MATCHES "^[0-9a-f]+ <${function}>:$")
+      set(inside TRUE)
+      set(found TRUE)
+      continue()
+    endif()
+    if (NOT inside)
+      continue()
+    endif()
+    if (NOT line MATCHES "^ *[0-9a-f]+:\t(.*)$")
+      break()
+    endif()
+
+    string(STRIP "${CMAKE_MATCH_1}" instruction)
+    if (instruction MATCHES "^(nop|data16|cs |xchg +ax,ax|endbr64|int3)")
+      continue()
+    endif()
+    # REGEX REPLACE would also strip the target of a direct call, since it
+    # matches `^` again after each replacement
+    string(REGEX MATCH "^([a-z0-9]+) *(.*)$" _ "${instruction}")
+    set(mnemonic "${CMAKE_MATCH_1}")
+    set(operands "${CMAKE_MATCH_2}")
+    math(EXPR instructions "${instructions} + 1")
+
+    # Memory operands other than the stack, which is read by push/pop/ret
+    # and addressed through rsp for spills and locals
+    if (operands MATCHES "\\[" AND NOT operands MATCHES "\\[rsp[]+-]"
+        AND NOT mnemonic STREQUAL "lea")
+      set(is_load TRUE)
+      # A mov into memory is a store, not a load
+      if (mnemonic MATCHES "^mov" AND operands MATCHES "^[^,]*\\[[^,]*,[^\\[]*$")
+        set(is_load FALSE)
+      endif()
+      if (is_load)
+        math(EXPR loads "${loads} + 1")
+      endif()
+    endif()
+
+    if (mnemonic MATCHES "^(jmp|call)$")
+      if (NOT operands MATCHES "^[0-9a-f]+ <")
+        math(EXPR indirect "${indirect} + 1")
+      endif()
+    endif()
+    if (mnemonic STREQUAL "call")
+      math(EXPR calls "${calls} + 1")
+    endif()
+  endforeach()
+
+  if (NOT found)
+    message(FATAL_ERROR "Function ${function} was not found in ${OBJECT}")
+  endif()
+  foreach(metric instructions loads indirect calls)
+    set(${metric}_count ${${metric}} PARENT_SCOPE)
+  endforeach()
+endfunction()
+
+file(STRINGS "${SOURCE}" expectations REGEX "^// CODEGEN(\\([A-Za-z]+\\))?: ")
+file(STRINGS "${SOURCE}" object_expectations REGEX "^// CODEGEN-OBJECT: ")
+if (NOT expectations AND NOT object_expectations)
+  message(FATAL_ERROR "No CODEGEN expectation in ${SOURCE}")
+endif()
+
+set(failed FALSE)
+if (object_expectations)
+  measure_object()
+endif()
+foreach(expectation IN LISTS object_expectations)
+  string(REGEX REPLACE "^// CODEGEN-OBJECT: +" "" checks "${expectation}")
+  string(REPLACE " " ";" checks "${checks}")
+  foreach(check IN LISTS checks)
+    if (NOT check MATCHES "^(dynamic_initializers|guard_variables)(=|<=)([0-9]+)$")
+      message(FATAL_ERROR "Invalid expectation '${check}' in ${SOURCE}")
+    endif()
+    set(metric ${CMAKE_MATCH_1})
+    set(op ${CMAKE_MATCH_2})
+    set(expected ${CMAKE_MATCH_3})
+    set(actual ${${metric}_count})
+    if ((op STREQUAL "=" AND NOT actual EQUAL expected) OR
+        (op STREQUAL "<=" AND actual GREATER expected))
+      message(SEND_ERROR "${OBJECT}: expected ${metric}${op}${expected}, got ${actual}")
+      set(failed TRUE)
+    endif()
+  endforeach()
+endforeach()
+
+foreach(expectation IN LISTS expectations)
+  string(REGEX MATCH "^// CODEGEN(\\(([A-Za-z]+)\\))?: +([A-Za-z_0-9]+) +(.*)$" _ "${expectation}")
+  set(compiler "${CMAKE_MATCH_2}")
+  set(function "${CMAKE_MATCH_3}")
+  string(REPLACE " " ";" checks "${CMAKE_MATCH_4}")
+  if (compiler AND NOT compiler STREQUAL COMPILER_ID)
+    continue()
+  endif()
+
+  measure(${function})
+  foreach(check IN LISTS checks)
+    if (NOT check MATCHES "^(instructions|loads|indirect|calls)(=|<=)([0-9]+)$")
+      message(FATAL_ERROR "Invalid expectation '${check}' in ${SOURCE}")
+    endif()
+    set(metric ${CMAKE_MATCH_1})
+    set(op ${CMAKE_MATCH_2})
+    set(expected ${CMAKE_MATCH_3})
+    set(actual ${${metric}_count})
+    if ((op STREQUAL "=" AND NOT actual EQUAL expected) OR
+        (op STREQUAL "<=" AND actual GREATER expected))
+      message(SEND_ERROR "${function}: expected ${metric}${op}${expected}, got ${actual}")
+      set(failed TRUE)
+    endif()
+  endforeach()
+endforeach()
+
+if (failed)
+  execute_process(COMMAND ${CMAKE_COMMAND} -E cat "${OBJECT}.asm")
+endif()
@@ -0,0 +1,39 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// Vtables are constexpr, so they are constant-initialized in read-only data:
+// nothing runs at startup to build them, and using one for the first time
+// doesn't check a guard variable.
+//
+// CODEGEN-OBJECT: dynamic_initializers=0 guard_variables=0
+// CODEGEN: car_vtable instructions<=2 loads=0 calls=0
+
+#include "vtable.hpp"
+
+#include <string>
+
+
+struct Car {
+  std::string make;
+  int year;
+  void accelerate() { ++year; }
+};
+
+struct Truck {
+  std::string make;
+  int year;
+  void accelerate() { ++year; }
+};
+
+struct Bike {
+  int year;
+  void accelerate() { ++year; }
+};
+
+extern "C" vtable const* car_vtable() { return &vtable_for<Car>; }
+extern "C" vtable const* truck_vtable() { return &vtable_for<Truck>; }
+extern "C" vtable const* bike_vtable() { return &vtable_for<Bike>; }
+
+extern "C" void call_accelerate(vtable const* vptr, void* object) {
+  vptr->accelerate(object);
+}
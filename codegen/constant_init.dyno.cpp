@@ -0,0 +1,39 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// Concept maps are constexpr, so the vtables Dyno builds from them are
+// constant-initialized too: creating the first poly of a type doesn't run
+// any initialization code or check a guard variable.
+//
+// CODEGEN-OBJECT: dynamic_initializers=0 guard_variables=0
+
+#include "functions.hpp"
+#include "vtable.dyno.hpp"
+
+#include <dyno.hpp>
+
+#include <new>
+#include <string>
+using namespace dyno::literals;
+
+
+struct Car {
+  std::string make;
+  int year;
+  void accelerate() { ++year; }
+};
+
+struct Truck {
+  std::string make;
+  int year;
+  void accelerate() { ++year; }
+};
+
+using Vehicle = dyno::poly<IVehicle, dyno::remote_storage>;
+
+extern "C" void make_car(void* p) { new (p) Vehicle{Car{"Audi", 2017}}; }
+extern "C" void make_truck(void* p) { new (p) Vehicle{Truck{"Chevrolet", 2015}}; }
+
+extern "C" void make_function(void* p) {
+  new (p) function<int(int)>{[](int i) { return i + 1; }};
+}
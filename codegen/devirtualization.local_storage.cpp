@@ -0,0 +1,24 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// With local storage, a Vehicle created and used locally is fully
+// devirtualized: the vtable pointer points to a constant vtable, and nothing
+// is allocated, so the compiler inlines both the call and the destructor.
+//
+// CODEGEN: accelerate_local_storage indirect=0 calls=0
+
+#include "local_storage.hpp"
+using local_storage::Vehicle;
+
+
+struct Car {
+  int speed;
+  void accelerate() { speed += 1; }
+};
+
+extern "C" int accelerate_local_storage(int speed) {
+  Vehicle vehicle{Car{speed}};
+  vehicle.accelerate();
+  vehicle.accelerate();
+  return 0;
+}
@@ -0,0 +1,25 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// Once the function pointers are stored in the object instead of behind a
+// pointer, a Vehicle created and used locally is devirtualized: the compiler
+// sees which function is in the object, and calls it directly. The object is
+// still allocated, so operator new and the deleter are called too.
+//
+// CODEGEN: accelerate_local_vtable indirect=0 calls<=4
+
+#include "local_vtable.hpp"
+using local_vtable::Vehicle;
+
+
+struct Car {
+  int speed;
+  void accelerate() { speed += 1; }
+};
+
+extern "C" int accelerate_local_vtable(int speed) {
+  Vehicle vehicle{Car{speed}};
+  vehicle.accelerate();
+  vehicle.accelerate();
+  return 0;
+}
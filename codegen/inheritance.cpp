@@ -0,0 +1,16 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// A virtual call loads the vtable pointer and the function pointer.
+//
+// CODEGEN: call_accelerate loads=2 indirect=1 instructions<=3
+
+
+struct Vehicle {
+  virtual void accelerate() = 0;
+  virtual ~Vehicle() { }
+};
+
+extern "C" void call_accelerate(Vehicle& vehicle) {
+  vehicle.accelerate();
+}
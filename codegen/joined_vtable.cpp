@@ -0,0 +1,15 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// With only accelerate stored in the object, dispatching it costs the same
+// as with a fully local vtable.
+//
+// CODEGEN: call_accelerate loads=2 indirect=1 instructions<=4
+
+#include "joined_vtable.hpp"
+using joined_vtable::Vehicle;
+
+
+extern "C" void call_accelerate(Vehicle& vehicle) {
+  vehicle.accelerate();
+}
@@ -0,0 +1,33 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// Same as joined_vtable.cpp: with accelerate stored in the object, the
+// vtable pointer is not loaded at all.
+//
+// CODEGEN: call_accelerate loads=2 indirect=1 instructions<=4
+
+#include "vtable.dyno.hpp"
+
+#include <dyno.hpp>
+
+#include <utility>
+using namespace dyno::literals;
+
+
+struct Vehicle {
+  template <typename Any>
+  Vehicle(Any vehicle) : poly_{std::move(vehicle)} { }
+
+  void accelerate()
+  { poly_.virtual_("accelerate"_s)(poly_); }
+
+private:
+  using VTable = dyno::vtable<
+                  dyno::local<dyno::only<decltype("accelerate"_s)>>,
+                  dyno::remote<dyno::everything_else>>;
+  dyno::poly<IVehicle, dyno::remote_storage, VTable> poly_;
+};
+
+extern "C" void call_accelerate(Vehicle& vehicle) {
+  vehicle.accelerate();
+}
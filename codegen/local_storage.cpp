@@ -0,0 +1,15 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// With local storage, the object lives right after the vtable pointer, so
+// only the vtable pointer and the function pointer are loaded.
+//
+// CODEGEN: call_accelerate loads=2 indirect=1 instructions<=5
+
+#include "local_storage.hpp"
+using local_storage::Vehicle;
+
+
+extern "C" void call_accelerate(Vehicle& vehicle) {
+  vehicle.accelerate();
+}
@@ -0,0 +1,15 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// With the vtable stored in the object, the function pointer is loaded
+// directly from the object, without going through a vtable pointer.
+//
+// CODEGEN: call_accelerate loads=2 indirect=1 instructions<=4
+
+#include "local_vtable.hpp"
+using local_vtable::Vehicle;
+
+
+extern "C" void call_accelerate(Vehicle& vehicle) {
+  vehicle.accelerate();
+}
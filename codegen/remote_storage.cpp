@@ -0,0 +1,15 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// Dispatching through remote storage loads the vtable pointer, the object
+// pointer and the function pointer.
+//
+// CODEGEN: call_accelerate loads=3 indirect=1 instructions<=5
+
+#include "remote_storage.hpp"
+using remote_storage::Vehicle;
+
+
+extern "C" void call_accelerate(Vehicle& vehicle) {
+  vehicle.accelerate();
+}
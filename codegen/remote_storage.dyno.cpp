@@ -0,0 +1,30 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// Looking up "accelerate"_s in Dyno's vtable happens at compile-time, so the
+// generated code is the same as with the hand-written vtable.
+//
+// CODEGEN: call_accelerate loads=3 indirect=1 instructions<=5
+
+#include "vtable.dyno.hpp"
+
+#include <dyno.hpp>
+
+#include <utility>
+using namespace dyno::literals;
+
+
+struct Vehicle {
+  template <typename Any>
+  Vehicle(Any vehicle) : poly_{std::move(vehicle)} { }
+
+  void accelerate()
+  { poly_.virtual_("accelerate"_s)(poly_); }
+
+private:
+  dyno::poly<IVehicle, dyno::remote_storage> poly_;
+};
+
+extern "C" void call_accelerate(Vehicle& vehicle) {
+  vehicle.accelerate();
+}
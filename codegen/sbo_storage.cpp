@@ -0,0 +1,15 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// With the small buffer optimization, the object pointer is selected from
+// on_heap_, which costs one more load and a branch or conditional move.
+//
+// CODEGEN: call_accelerate loads<=4 indirect=1 instructions<=8
+
+#include "sbo_storage.hpp"
+using Vehicle = sbo_storage::Vehicle<16>;
+
+
+extern "C" void call_accelerate(Vehicle& vehicle) {
+  vehicle.accelerate();
+}
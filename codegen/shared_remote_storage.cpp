@@ -0,0 +1,15 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// Shared remote storage dispatches exactly like remote storage; the
+// reference count is not touched by a call.
+//
+// CODEGEN: call_accelerate loads=3 indirect=1 instructions<=5
+
+#include "shared_remote_storage.hpp"
+using shared_remote_storage::Vehicle;
+
+
+extern "C" void call_accelerate(Vehicle& vehicle) {
+  vehicle.accelerate();
+}
@@ -0,0 +1,21 @@
+// Copyright Louis Dionne 2018
+// Distributed under the Boost Software License, Version 1.0.
+
+// Calling two virtual functions in a row reloads the vtable pointer after the
+// first call, since it could have changed the dynamic type of the object.
+// Clang's -fstrict-vtable-pointers (enabled for this test when building with
+// Clang) assumes it doesn't, and reuses the vtable pointer.
+//
+// CODEGEN(GNU): accelerate_twice loads=4 indirect=2
+// CODEGEN(Clang): accelerate_twice loads<=3 indirect=2
+
+
+struct Vehicle {
+  virtual void accelerate() = 0;
+  virtual ~Vehicle() { }
+};
+
+extern "C" void accelerate_twice(Vehicle& vehicle) {
+  vehicle.accelerate();
+  vehicle.accelerate();
+}